@@ -0,0 +1,59 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace bench {
+
+Options& options() {
+    static Options opts;
+    return opts;
+}
+
+std::vector<Benchmark>& allBenchmarks() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+std::chrono::nanoseconds Runner::timeOnce(const Benchmark& benchmark, std::uint64_t iterations) {
+    State state{iterations};
+
+    const auto start = State::Clock::now();
+    benchmark.func(state);
+    const auto elapsed = State::Clock::now() - start - state.paused_;
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+}
+
+Result Runner::run(const Benchmark& benchmark) const {
+    std::uint64_t iterations = benchmark.fixedIterations;
+
+    if (iterations == 0) {
+        iterations = 1;
+        while (true) {
+            const auto elapsed = timeOnce(benchmark, iterations);
+            if (elapsed >= minTime_) {
+                break;
+            }
+
+            // Aim straight for the minimum time once the measurement is long enough to be trusted
+            if (elapsed >= minTime_ / 10) {
+                const double scale = static_cast<double>(minTime_.count()) / static_cast<double>(elapsed.count());
+                iterations = static_cast<std::uint64_t>(static_cast<double>(iterations) * scale * 1.1) + 1;
+                break;
+            }
+            iterations *= 10;
+        }
+    }
+
+    auto best = std::chrono::nanoseconds::max();
+    for (int i = 0; i < repetitions_; ++i) {
+        best = std::min(best, timeOnce(benchmark, iterations));
+    }
+
+    return Result{.name = benchmark.name,
+                  .iterations = iterations,
+                  .nsPerOp = static_cast<double>(best.count()) / static_cast<double>(iterations)};
+}
+
+} // namespace bench
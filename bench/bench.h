@@ -0,0 +1,98 @@
+// Minimal benchmarking harness for the bank_accounts_bench target
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+//! Settings for the macro benchmarks, taken from the command line
+struct Options
+{
+    std::size_t numAccounts = 1000; // Of each account type
+    int numDays = 365;
+    std::size_t numThreads = 1;
+};
+
+Options& options();
+
+/**
+ * @brief Handed to each benchmark, which must perform its operation `iterations()` times.
+ *
+ * Setup which should not count towards the result can be excluded with @ref pauseTiming and @ref resumeTiming.
+ */
+class State
+{
+public:
+    explicit State(std::uint64_t iterations)
+        : iterations_{iterations} {}
+
+    std::uint64_t iterations() const { return iterations_; }
+
+    void pauseTiming() { pausedAt_ = Clock::now(); }
+    void resumeTiming() { paused_ += Clock::now() - pausedAt_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    friend class Runner;
+
+    std::uint64_t iterations_;
+    Clock::duration paused_{};
+    Clock::time_point pausedAt_{};
+};
+
+struct Benchmark
+{
+    std::string name;
+    std::function<void(State&)> func;
+    // Expensive benchmarks run a set number of iterations instead of being calibrated to the minimum run time
+    std::uint64_t fixedIterations = 0;
+};
+
+std::vector<Benchmark>& allBenchmarks();
+
+//! Registers a benchmark from a static initializer
+struct Registrar
+{
+    Registrar(std::string name, std::function<void(State&)> func, std::uint64_t fixedIterations = 0) {
+        allBenchmarks().push_back(Benchmark{std::move(name), std::move(func), fixedIterations});
+    }
+};
+
+//! Prevents the compiler from optimizing away a value which is otherwise unused
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result
+{
+    std::string name;
+    std::uint64_t iterations;
+    double nsPerOp;
+};
+
+class Runner
+{
+public:
+    explicit Runner(std::chrono::nanoseconds minTime, int repetitions)
+        : minTime_{minTime}
+        , repetitions_{repetitions} {}
+
+    //! Takes the fastest of several repetitions, after calibrating the number of iterations to the minimum run time
+    Result run(const Benchmark& benchmark) const;
+
+private:
+    static std::chrono::nanoseconds timeOnce(const Benchmark& benchmark, std::uint64_t iterations);
+
+    std::chrono::nanoseconds minTime_;
+    int repetitions_;
+};
+
+} // namespace bench
@@ -0,0 +1,378 @@
+#include "account_book.h"
+#include "account_info.h"
+#include "account_store.h"
+#include "bank_account.h"
+#include "bench.h"
+#include "cd_account.h"
+#include "hi_checking_account.h"
+#include "hi_savings_account.h"
+#include "interest_handler.h"
+#include "journal.h"
+#include "nosc_checking_account.h"
+#include "savings_account.h"
+#include "sc_checking_account.h"
+#include "snapshot.h"
+#include "statement_renderer.h"
+#include "transaction.h"
+#include "util/date_util.h"
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Exposes statement recording without any of the account logic around it
+class RecordingAccount : public AccountInfo
+{
+public:
+    using AccountInfo::AccountInfo;
+    using AccountInfo::addToMonthlyStatement;
+};
+
+const bench::Registrar statementAddRecord{
+    "statement/add_record", [](bench::State& state) {
+        RecordingAccount account{"bench", 1'000_dollars, SimTimeManager::getDate()};
+        Date date = SimTimeManager::getDate();
+
+        for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+            // Around as many records a day as a busy account would see
+            if (i % 8 == 0) {
+                date = date + std::chrono::days{1};
+            }
+            account.addToMonthlyStatement(date, {
+                                                    .event = StatementRecordInfo::Event::Deposit,
+                                                    .balanceChange = 1_dollars,
+                                                    .changeType = StatementRecordInfo::Increase,
+                                                    .resultantBalance = account.getBalance(),
+                                                });
+        }
+        bench::doNotOptimize(account);
+    }};
+
+//! Copies an account which has been open for `years` years, with a record for every day's interest
+void copyAccount(bench::State& state, int years) {
+    state.pauseTiming();
+    SimTimeManager::resetDay();
+    const InterestHandler daily{InterestType::Daily, 0.0001};
+    std::optional<HighInterestCheckingAccount> account{
+        std::in_place, "hi_checking", 10'000_dollars, daily, SimTimeManager{}};
+    SimTimeManager::incrDay(std::chrono::days{365 * years});
+    SimTimeManager::updateAll();
+    state.resumeTiming();
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        auto copy = *account;
+        bench::doNotOptimize(copy);
+    }
+
+    state.pauseTiming();
+    account.reset();
+    state.resumeTiming();
+}
+
+const bench::Registrar copyNewAccount{"accounts/copy_new", [](bench::State& state) { copyAccount(state, 0); }};
+const bench::Registrar copyAgedAccount{"accounts/copy_20_years", [](bench::State& state) { copyAccount(state, 20); }};
+
+//! `numEach` accounts of each of the six account types
+std::vector<BankAccount> makeBook(std::size_t numEach) {
+    const InterestHandler daily{InterestType::Daily, 0.0001};
+    const InterestHandler monthly{InterestType::Monthly, 0.003};
+
+    std::vector<BankAccount> book;
+    book.reserve(numEach * 6);
+    for (std::size_t i = 0; i < numEach; ++i) {
+        const Money balance = 5'000_dollars + Money{static_cast<int>(i % 1000), 0};
+        book.emplace_back(SavingsAccount("savings", balance, monthly, SimTimeManager{}));
+        book.emplace_back(HighInterestSavingsAccount("hi_savings", balance, daily, SimTimeManager{}));
+        book.emplace_back(
+            CertificateOfDepositAccount("cd", balance, std::chrono::months{24}, 0.1, daily, SimTimeManager{}));
+        book.emplace_back(ServiceChargeCheckingAccount("sc_checking", balance, SimTimeManager{}));
+        book.emplace_back(NoServiceChargeCheckingAccount("nosc_checking", balance, monthly, SimTimeManager{}));
+        book.emplace_back(HighInterestCheckingAccount("hi_checking", balance, daily, SimTimeManager{}));
+    }
+
+    return book;
+}
+
+/**
+ * @brief Steps a freshly opened book through `numDays` days, either a day at a time or in one update.
+ *
+ * One operation is the whole simulation, so results depend on the --accounts, --days and --threads options.
+ */
+void stepBook(bench::State& state, bool daily) {
+    const auto& opts = bench::options();
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        state.pauseTiming();
+        SimTimeManager::resetDay();
+        SimTimeManager::setUpdateThreads(opts.numThreads);
+        auto book = makeBook(opts.numAccounts);
+        state.resumeTiming();
+
+        if (daily) {
+            for (int day = 0; day < opts.numDays; ++day) {
+                SimTimeManager::incrDay();
+                SimTimeManager::updateAll();
+            }
+        } else {
+            SimTimeManager::incrDay(std::chrono::days{opts.numDays});
+            SimTimeManager::updateAll();
+        }
+
+        state.pauseTiming();
+        bench::doNotOptimize(book);
+        book.clear();
+        SimTimeManager::setUpdateThreads(1);
+        state.resumeTiming();
+    }
+}
+
+//! The same accounts as `makeBook`, held by concrete type
+AccountBook makeAccountBook(std::size_t numEach) {
+    const InterestHandler daily{InterestType::Daily, 0.0001};
+    const InterestHandler monthly{InterestType::Monthly, 0.003};
+
+    AccountBook book;
+    for (std::size_t i = 0; i < numEach; ++i) {
+        const Money balance = 5'000_dollars + Money{static_cast<int>(i % 1000), 0};
+        book.insert(SavingsAccount("savings", balance, monthly, SimTimeManager{}));
+        book.insert(HighInterestSavingsAccount("hi_savings", balance, daily, SimTimeManager{}));
+        book.insert(CertificateOfDepositAccount("cd", balance, std::chrono::months{24}, 0.1, daily, SimTimeManager{}));
+        book.insert(ServiceChargeCheckingAccount("sc_checking", balance, SimTimeManager{}));
+        book.insert(NoServiceChargeCheckingAccount("nosc_checking", balance, monthly, SimTimeManager{}));
+        book.insert(HighInterestCheckingAccount("hi_checking", balance, daily, SimTimeManager{}));
+    }
+
+    return book;
+}
+
+/**
+ * @brief Sums the balance of every account in a freshly opened book, with `sum` doing one pass over the book.
+ *
+ * One operation is the whole pass, so results depend on the --accounts option.
+ */
+template <typename Book, typename SumFn>
+void sumBalances(bench::State& state, Book (*make)(std::size_t), SumFn sum) {
+    state.pauseTiming();
+    SimTimeManager::resetDay();
+    auto book = make(bench::options().numAccounts);
+    state.resumeTiming();
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        Money total = sum(book);
+        bench::doNotOptimize(total);
+    }
+
+    state.pauseTiming();
+    book = Book{};
+    state.resumeTiming();
+}
+
+const bench::Registrar sumBalancesErased{"accounts/sum_balances_erased", [](bench::State& state) {
+                                             sumBalances(state, makeBook, [](const auto& book) {
+                                                 Money total = 0_dollars;
+                                                 for (const auto& account : book) {
+                                                     total += account.getBalance();
+                                                 }
+                                                 return total;
+                                             });
+                                         }};
+
+const bench::Registrar sumBalancesBook{"accounts/sum_balances_book", [](bench::State& state) {
+                                           sumBalances(state, makeAccountBook, [](const auto& book) {
+                                               Money total = 0_dollars;
+                                               book.forEach([&](const auto& acc) { total += acc.getBalance(); });
+                                               return total;
+                                           });
+                                       }};
+
+//! A day's deposits and withdrawals for one account, either applied as a batch or one call at a time
+void applyDay(bench::State& state, bool batched) {
+    constexpr std::size_t NUM_TRANSACTIONS = 64;
+
+    state.pauseTiming();
+    SimTimeManager::resetDay();
+    std::vector<Transaction> transactions;
+    for (std::size_t i = 0; i < NUM_TRANSACTIONS; ++i) {
+        const Money amount{static_cast<int>(i % 50), 25};
+        transactions.push_back({i % 2 == 0 ? Transaction::Type::Deposit : Transaction::Type::Withdrawal, amount});
+    }
+    std::optional<BankAccount> account{ServiceChargeCheckingAccount("sc_checking", 10'000_dollars, SimTimeManager{})};
+    state.resumeTiming();
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        // Without running updates, so that only the transactions are measured
+        SimTimeManager::incrDay();
+        if (batched) {
+            bench::doNotOptimize(account->apply(transactions));
+        } else {
+            for (const auto& transaction : transactions) {
+                if (transaction.type == Transaction::Type::Deposit) {
+                    account->deposit(transaction.amount);
+                } else {
+                    account->withdraw(transaction.amount);
+                }
+            }
+        }
+    }
+
+    state.pauseTiming();
+    account.reset();
+    state.resumeTiming();
+}
+
+const bench::Registrar applyBatch{"accounts/apply_batch_64", [](bench::State& state) { applyDay(state, true); }};
+const bench::Registrar applySingle{"accounts/apply_single_64", [](bench::State& state) { applyDay(state, false); }};
+
+const bench::Registrar bookStepDaily{"accounts/step_daily", [](bench::State& state) { stepBook(state, true); }, 1};
+const bench::Registrar bookStepSingle{"accounts/step_single", [](bench::State& state) { stepBook(state, false); },
+                                      1};
+
+/**
+ * @brief Writes a snapshot of a book which has been open for `--days` days, or loads one back.
+ *
+ * One operation is the whole book, so results depend on the --accounts and --days options.
+ */
+void snapshotBook(bench::State& state, bool load) {
+    const auto& opts = bench::options();
+    const auto path = std::filesystem::temp_directory_path() / "bank_accounts_bench_snapshot.bin";
+
+    state.pauseTiming();
+    SimTimeManager::resetDay();
+    std::optional<std::vector<BankAccount>> book{makeBook(opts.numAccounts)};
+    SimTimeManager::incrDay(std::chrono::days{opts.numDays});
+    SimTimeManager::updateAll();
+    state.resumeTiming();
+
+    auto write = [&] {
+        SnapshotWriter writer;
+        for (const auto& account : *book) {
+            writer.add(account);
+        }
+        writer.write(path);
+    };
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        if (!load) {
+            write();
+            continue;
+        }
+
+        state.pauseTiming();
+        write();
+        AccountStore<BankAccount> restored;
+        state.resumeTiming();
+
+        const Snapshot snapshot{path};
+        snapshot.loadInto(restored);
+
+        state.pauseTiming();
+        bench::doNotOptimize(restored);
+        restored = AccountStore<BankAccount>{};
+        state.resumeTiming();
+    }
+
+    state.pauseTiming();
+    book.reset();
+    std::filesystem::remove(path);
+    state.resumeTiming();
+}
+
+const bench::Registrar snapshotWrite{"accounts/snapshot_write",
+                                     [](bench::State& state) { snapshotBook(state, false); }, 1};
+const bench::Registrar snapshotLoad{"accounts/snapshot_load", [](bench::State& state) { snapshotBook(state, true); },
+                                    1};
+
+/**
+ * @brief Renders every statement of a book which has been open for `--days` days, or writes them all to a file.
+ *
+ * Rendering either reuses one StatementRenderer, or formats each account's statements into a new string as showing
+ * them used to. One operation is the whole book.
+ */
+enum class RenderMode { Reused, Joined, Exported };
+
+void renderBook(bench::State& state, RenderMode mode) {
+    using enum RenderMode;
+    const auto& opts = bench::options();
+    const auto path = std::filesystem::temp_directory_path() / "bank_accounts_bench_statements.txt";
+
+    state.pauseTiming();
+    SimTimeManager::resetDay();
+    std::optional<std::vector<BankAccount>> book{makeBook(opts.numAccounts)};
+    SimTimeManager::incrDay(std::chrono::days{opts.numDays});
+    SimTimeManager::updateAll();
+    state.resumeTiming();
+
+    StatementRenderer renderer;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        if (mode == Exported) {
+            StatementExporter exporter{path};
+            for (const auto& account : *book) {
+                exporter.add(account);
+            }
+            exporter.flush();
+            continue;
+        }
+
+        for (const auto& account : *book) {
+            if (mode == Joined) {
+                auto text = fmt::format("{}", fmt::join(account.getAllMonthlyStatements(), "\n\n"));
+                bench::doNotOptimize(text);
+                continue;
+            }
+            renderer.clear();
+            renderer.renderAll(account);
+            bench::doNotOptimize(renderer);
+        }
+    }
+
+    state.pauseTiming();
+    book.reset();
+    std::filesystem::remove(path);
+    state.resumeTiming();
+}
+
+const bench::Registrar statementsRender{"accounts/statements_render",
+                                        [](bench::State& state) { renderBook(state, RenderMode::Reused); }, 1};
+const bench::Registrar statementsJoin{"accounts/statements_join",
+                                      [](bench::State& state) { renderBook(state, RenderMode::Joined); }, 1};
+const bench::Registrar statementsExport{"accounts/statements_export",
+                                        [](bench::State& state) { renderBook(state, RenderMode::Exported); }, 1};
+
+/**
+ * @brief Journals deposits, either leaving group commit to batch them or waiting for each one to reach the disk.
+ */
+void journalDeposits(bench::State& state, bool syncEach) {
+    const auto path = std::filesystem::temp_directory_path() / "bank_accounts_bench_journal.bin";
+
+    state.pauseTiming();
+    std::filesystem::remove(path);
+    std::optional<Journal> journal;
+    journal.emplace(path);
+    state.resumeTiming();
+
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        journal->record(static_cast<int>(i % 1000), {Transaction::Type::Deposit, 1_dollars});
+        if (syncEach) {
+            journal->sync();
+        }
+    }
+    journal->sync();
+
+    state.pauseTiming();
+    journal.reset();
+    std::filesystem::remove(path);
+    state.resumeTiming();
+}
+
+const bench::Registrar journalGroupCommit{"journal/group_commit",
+                                          [](bench::State& state) { journalDeposits(state, false); }};
+const bench::Registrar journalSyncEach{"journal/sync_each", [](bench::State& state) { journalDeposits(state, true); }};
+
+} // namespace
@@ -0,0 +1,55 @@
+#include "bench.h"
+#include "interest_handler.h"
+#include "util/date_util.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace {
+
+constexpr Date START{std::chrono::year{2024} / std::chrono::January / 1};
+
+const bench::Registrar dateDiffDays{"date/diff_days", [](bench::State& state) {
+                                        Date date = START;
+                                        for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                                            auto diff = Date::diff(START, date);
+                                            bench::doNotOptimize(diff);
+                                            date = date + std::chrono::days{1};
+                                        }
+                                    }};
+
+const bench::Registrar dateDiffMonths{"date/diff_months", [](bench::State& state) {
+                                          Date date = START;
+                                          for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                                              auto diff = Date::diff<std::chrono::months>(START, date);
+                                              bench::doNotOptimize(diff);
+                                              date = date + std::chrono::days{1};
+                                          }
+                                      }};
+
+const bench::Registrar dateMonthsBetween{"date/months_between", [](bench::State& state) {
+                                             Date date = START;
+                                             for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                                                 auto diff = Date::monthsBetween(START, date);
+                                                 bench::doNotOptimize(diff);
+                                                 date = date + std::chrono::days{1};
+                                             }
+                                         }};
+
+// One operation is a full year of payouts
+void processYear(bench::State& state, InterestType type) {
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        InterestHandler handler{type, 0.0001};
+        Rate total = 0.0;
+        handler.processDuring(START, START + std::chrono::days{365},
+                              [&](Date /*when*/, Rate rate) { total = total + rate; });
+        bench::doNotOptimize(total);
+    }
+}
+
+const bench::Registrar interestDaily{"interest/daily_year",
+                                     [](bench::State& state) { processYear(state, InterestType::Daily); }};
+const bench::Registrar interestMonthly{"interest/monthly_year",
+                                       [](bench::State& state) { processYear(state, InterestType::Monthly); }};
+
+} // namespace
@@ -0,0 +1,152 @@
+#include "bench.h"
+#include "hi_checking_account.h"
+#include "interest_handler.h"
+#include "sc_checking_account.h"
+#include "transaction.h"
+#include "transaction_engine.h"
+#include "transaction_import.h"
+#include "util/date_util.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+//! Opens `--accounts` accounts of each of two checking types, returning their numbers
+std::vector<int> openAccounts(TransactionEngine& engine) {
+    SimTimeManager::resetDay();
+    const InterestHandler daily{InterestType::Daily, 0.0001};
+    std::vector<int> numbers;
+    for (std::size_t i = 0; i < bench::options().numAccounts; ++i) {
+        numbers.push_back(engine.open(ServiceChargeCheckingAccount("sc_checking", 10'000_dollars, SimTimeManager{})));
+        numbers.push_back(
+            engine.open(HighInterestCheckingAccount("hi_checking", 10'000_dollars, daily, SimTimeManager{})));
+    }
+    return numbers;
+}
+
+/**
+ * @brief Runs `state.iterations()` operations split over `--threads` threads, with an engine opened by openAccounts.
+ *
+ * `work(engine, numbers, rng, i)` performs operation `i` of its thread. Opening and closing the accounts is untimed.
+ */
+template <typename Work>
+void runOnThreads(bench::State& state, Work work) {
+    state.pauseTiming();
+    std::optional<TransactionEngine> engine{std::in_place};
+    const auto numbers = openAccounts(*engine);
+    state.resumeTiming();
+
+    auto runThread = [&](std::size_t thread, std::uint64_t count) {
+        std::mt19937 rng{static_cast<unsigned>(thread)};
+        for (std::uint64_t i = 0; i < count; ++i) {
+            work(*engine, numbers, rng, i);
+        }
+    };
+
+    const std::size_t numThreads = std::max<std::size_t>(bench::options().numThreads, 1);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 1; t < numThreads; ++t) {
+        threads.emplace_back(runThread, t, state.iterations() / numThreads);
+    }
+    runThread(0, state.iterations() - state.iterations() / numThreads * (numThreads - 1));
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    state.pauseTiming();
+    engine.reset();
+    state.resumeTiming();
+}
+
+int pickAccount(const std::vector<int>& numbers, std::mt19937& rng) {
+    return numbers[std::uniform_int_distribution<std::size_t>{0, numbers.size() - 1}(rng)];
+}
+
+// One operation is one transaction, so ns/op falls as threads are added for as long as throughput scales
+
+//! Random deposits, withdrawals and checks
+const bench::Registrar engineTransactions{
+    "engine/transactions", [](bench::State& state) {
+        runOnThreads(state, [](TransactionEngine& engine, const std::vector<int>& numbers, std::mt19937& rng,
+                               std::uint64_t i) {
+            const int number = pickAccount(numbers, rng);
+            const Money amount{static_cast<int>(i % 100), 0};
+            switch (i % 3) {
+            case 0:
+                engine.deposit(number, amount);
+                break;
+            case 1:
+                engine.withdraw(number, amount);
+                break;
+            default:
+                engine.writeCheck(number, amount);
+                break;
+            }
+        });
+    }};
+
+//! Transfers between random pairs of accounts, which lock two shards each
+const bench::Registrar engineTransfers{
+    "engine/transfers", [](bench::State& state) {
+        runOnThreads(state, [](TransactionEngine& engine, const std::vector<int>& numbers, std::mt19937& rng,
+                               std::uint64_t i) {
+            const int from = pickAccount(numbers, rng);
+            int to = pickAccount(numbers, rng);
+            if (to == from) {
+                to = numbers[0] == from ? numbers[1] : numbers[0];
+            }
+            engine.transfer(from, to, Money{static_cast<int>(i % 100), 0});
+        });
+    }};
+
+/**
+ * @brief Imports a CSV file of `state.iterations()` rows spread over a month, parsing and applying on `--threads`.
+ *
+ * One operation is one row. Writing the file and opening the accounts is untimed.
+ */
+const bench::Registrar engineImportCsv{
+    "engine/import_csv", [](bench::State& state) {
+        constexpr std::uint64_t NUM_DAYS = 30;
+        const auto path = std::filesystem::temp_directory_path() / "bank_accounts_bench_import.csv";
+
+        state.pauseTiming();
+        std::optional<TransactionEngine> engine{std::in_place};
+        const auto numbers = openAccounts(*engine);
+        {
+            const auto today = SimTimeManager::getDate();
+            std::ofstream file{path};
+            fmt::memory_buffer rows;
+            constexpr std::array TYPES = {"deposit", "withdrawal", "check"};
+            for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                const auto date = today + std::chrono::days{static_cast<int>(i * NUM_DAYS / state.iterations())};
+                fmt::format_to(fmt::appender(rows), "{},{:%F},{},\"{}\"\n", numbers[i % numbers.size()], date,
+                               TYPES.at(i % TYPES.size()), Money::fromCents(i % 100'000));
+            }
+            file.write(rows.data(), static_cast<std::streamsize>(rows.size()));
+        }
+        state.resumeTiming();
+
+        const auto report = importTransactions(path, *engine, {.numThreads = bench::options().numThreads,
+                                                               .chunkSize = ImportOptions{}.chunkSize,
+                                                               .maxRejections = ImportOptions{}.maxRejections});
+        bench::doNotOptimize(report);
+
+        state.pauseTiming();
+        engine.reset();
+        std::filesystem::remove(path);
+        state.resumeTiming();
+    }};
+
+} // namespace
@@ -0,0 +1,105 @@
+#include "bench.h"
+#include "money_type.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+const bench::Registrar moneyAdd{"money/add", [](bench::State& state) {
+                                    Money total = 0_dollars;
+                                    const Money step{1, 23};
+                                    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                                        total = total + step;
+                                        bench::doNotOptimize(total);
+                                    }
+                                }};
+
+const bench::Registrar moneyMultiplyRate{"money/multiply_rate", [](bench::State& state) {
+                                             Money balance = 12'345_dollars;
+                                             const Rate rate = 0.0125;
+                                             for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                                                 auto interest = balance * rate;
+                                                 bench::doNotOptimize(interest);
+                                                 balance += Money::fromCents(1);
+                                             }
+                                         }};
+
+// Formats the way amounts used to be, appending each digit and comma to a string which is then reversed
+std::string legacyFormat(Money amount) {
+    std::string grouped;
+    std::size_t numDigits = 0;
+    for (auto val = amount.dollars(); val > 0; val /= 10, ++numDigits) {
+        if (numDigits != 0 && numDigits % 3 == 0) {
+            grouped += std::string{","};
+        }
+        grouped += std::string{static_cast<char>('0' + val % 10)};
+    }
+    std::reverse(grouped.begin(), grouped.end());
+    return fmt::format("${}.{:02}", grouped, amount.cents());
+}
+
+const bench::Registrar moneyFormatLegacy{"money/format_legacy", [](bench::State& state) {
+                                             Money balance = 1'234'567_dollars;
+                                             for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                                                 auto str = fmt::format("{}", legacyFormat(balance));
+                                                 bench::doNotOptimize(str);
+                                                 balance += Money::fromCents(1);
+                                             }
+                                         }};
+
+const bench::Registrar moneyFormatBuffer{"money/format_to_buffer", [](bench::State& state) {
+                                             Money balance = 1'234'567_dollars;
+                                             fmt::memory_buffer buffer;
+                                             for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                                                 buffer.clear();
+                                                 fmt::format_to(fmt::appender(buffer), "{}", balance);
+                                                 bench::doNotOptimize(buffer);
+                                                 balance += Money::fromCents(1);
+                                             }
+                                         }};
+
+const bench::Registrar moneyFormat{"money/format", [](bench::State& state) {
+                                       Money balance = 1'234'567_dollars;
+                                       for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+                                           auto str = fmt::format("{}", balance);
+                                           bench::doNotOptimize(str);
+                                           balance += Money::fromCents(1);
+                                       }
+                                   }};
+
+/**
+ * @brief Parses amounts as they would come from an import file, either grouped like `$1,234.56` or plain digits.
+ */
+void parseAmounts(bench::State& state, bool grouped) {
+    constexpr std::size_t NUM_AMOUNTS = 4096;
+
+    state.pauseTiming();
+    std::vector<std::string> amounts;
+    amounts.reserve(NUM_AMOUNTS);
+    for (std::size_t i = 0; i < NUM_AMOUNTS; ++i) {
+        const auto amount = Money::fromCents(i * 7'919'993 % 10'000'000'000);
+        amounts.push_back(grouped ? fmt::format("{}", amount)
+                                  : fmt::format("{}.{:02}", amount.dollars(), amount.cents()));
+    }
+    state.resumeTiming();
+
+    Money total;
+    for (std::uint64_t i = 0; i < state.iterations(); ++i) {
+        Money amount;
+        parseMoney(amounts[i % NUM_AMOUNTS], amount);
+        total += amount;
+    }
+    bench::doNotOptimize(total);
+}
+
+const bench::Registrar moneyParseGrouped{"money/parse_grouped",
+                                         [](bench::State& state) { parseAmounts(state, true); }};
+const bench::Registrar moneyParsePlain{"money/parse_plain", [](bench::State& state) { parseAmounts(state, false); }};
+
+} // namespace
@@ -0,0 +1,192 @@
+// Runs the registered benchmarks, optionally writing the results as JSON and comparing them against a baseline
+// previously written by this program.
+//
+// Usage: bank_accounts_bench [--filter <text>] [--json <file>] [--baseline <file>] [--tolerance <percent>]
+//                            [--min-time <ms>] [--repetitions <n>] [--accounts <n>] [--days <n>] [--threads <n>]
+
+#include "bench.h"
+
+#include <fmt/core.h>
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Arguments
+{
+    std::string filter;
+    std::string jsonPath;
+    std::string baselinePath;
+    double tolerancePercent = 10.0;
+    std::chrono::milliseconds minTime{200};
+    int repetitions = 5;
+};
+
+Arguments parseArguments(int argc, char** argv) {
+    Arguments args;
+    auto& opts = bench::options();
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument(fmt::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--filter") {
+            args.filter = value();
+        } else if (arg == "--json") {
+            args.jsonPath = value();
+        } else if (arg == "--baseline") {
+            args.baselinePath = value();
+        } else if (arg == "--tolerance") {
+            args.tolerancePercent = std::stod(value());
+        } else if (arg == "--min-time") {
+            args.minTime = std::chrono::milliseconds{std::stol(value())};
+        } else if (arg == "--repetitions") {
+            args.repetitions = std::stoi(value());
+        } else if (arg == "--accounts") {
+            opts.numAccounts = std::stoul(value());
+        } else if (arg == "--days") {
+            opts.numDays = std::stoi(value());
+        } else if (arg == "--threads") {
+            opts.numThreads = std::stoul(value());
+        } else {
+            throw std::invalid_argument(fmt::format("Unknown argument {}", arg));
+        }
+    }
+
+    return args;
+}
+
+void writeJson(const std::string& path, const std::vector<bench::Result>& results) {
+    std::ofstream out{path};
+    if (!out) {
+        throw std::runtime_error(fmt::format("Failed to open {} for writing", path));
+    }
+
+    // Macro benchmark results are only comparable between runs with the same options
+    const auto& opts = bench::options();
+    out << fmt::format("{{\n  \"options\": {{\"accounts\": {}, \"days\": {}, \"threads\": {}}},\n", opts.numAccounts,
+                       opts.numDays, opts.numThreads);
+
+    // One benchmark per line, which is also what `readBaseline` relies on
+    out << "  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        out << fmt::format("    {{\"name\": \"{}\", \"iterations\": {}, \"ns_per_op\": {:.3f}}}{}\n", result.name,
+                           result.iterations, result.nsPerOp, i + 1 < results.size() ? "," : "");
+    }
+    out << "  ]\n}\n";
+}
+
+//! Results of an earlier run, keyed by benchmark name, which must have been run with the current options
+std::map<std::string, double> readBaseline(const std::string& path) {
+    std::ifstream in{path};
+    if (!in) {
+        throw std::runtime_error(fmt::format("Failed to open baseline {}", path));
+    }
+
+    static const std::regex optionsEntry{
+        R"re("options": \{"accounts": ([0-9]+), "days": (-?[0-9]+), "threads": ([0-9]+)\})re"};
+    static const std::regex entry{R"re("name": "([^"]+)",.*"ns_per_op": ([0-9.eE+-]+))re"};
+
+    bool hasOptions = false;
+    std::map<std::string, double> baseline;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::smatch match;
+        if (std::regex_search(line, match, optionsEntry)) {
+            const auto& opts = bench::options();
+            const auto numAccounts = std::stoul(match[1].str());
+            const auto numDays = std::stoi(match[2].str());
+            const auto numThreads = std::stoul(match[3].str());
+            if (numAccounts != opts.numAccounts || numDays != opts.numDays || numThreads != opts.numThreads) {
+                throw std::runtime_error(fmt::format(
+                    "Baseline {} was run with --accounts {} --days {} --threads {}, but this run uses --accounts {} "
+                    "--days {} --threads {}, so the results are not comparable",
+                    path, numAccounts, numDays, numThreads, opts.numAccounts, opts.numDays, opts.numThreads));
+            }
+            hasOptions = true;
+        } else if (std::regex_search(line, match, entry)) {
+            baseline[match[1].str()] = std::stod(match[2].str());
+        }
+    }
+
+    if (!hasOptions) {
+        throw std::runtime_error(fmt::format("Baseline {} does not record the options it was run with", path));
+    }
+
+    return baseline;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const auto args = parseArguments(argc, argv);
+        const bench::Runner runner{args.minTime, args.repetitions};
+
+        std::map<std::string, double> baseline;
+        if (!args.baselinePath.empty()) {
+            baseline = readBaseline(args.baselinePath);
+        }
+
+        std::vector<bench::Result> results;
+        int numRegressions = 0;
+
+        fmt::print("{:<40} {:>14} {:>14} {:>10}\n", "Benchmark", "Iterations", "ns/op", "Change");
+        // Registration order depends on static initialization, so sort for a stable report
+        auto benchmarks = bench::allBenchmarks();
+        std::sort(benchmarks.begin(), benchmarks.end(),
+                  [](const auto& lhs, const auto& rhs) { return lhs.name < rhs.name; });
+
+        for (const auto& benchmark : benchmarks) {
+            if (benchmark.name.find(args.filter) == std::string::npos) {
+                continue;
+            }
+
+            const auto& result = results.emplace_back(runner.run(benchmark));
+
+            std::string change;
+            if (auto iter = baseline.find(result.name); iter != baseline.end() && iter->second > 0) {
+                const double percent = (result.nsPerOp / iter->second - 1.0) * 100.0;
+                change = fmt::format("{:+.1f}%", percent);
+                if (percent > args.tolerancePercent) {
+                    change += " REGRESSION";
+                    ++numRegressions;
+                }
+            }
+
+            fmt::print("{:<40} {:>14} {:>14.2f} {:>10}\n", result.name, result.iterations, result.nsPerOp, change);
+            std::fflush(stdout);
+        }
+
+        if (!args.jsonPath.empty()) {
+            writeJson(args.jsonPath, results);
+        }
+
+        if (numRegressions > 0) {
+            fmt::print("{} benchmark(s) regressed by more than {}%\n", numRegressions, args.tolerancePercent);
+            return 1;
+        }
+    } catch (const std::exception& err) {
+        fmt::print(stderr, "{}\n", err.what());
+        return 2;
+    }
+
+    return 0;
+}
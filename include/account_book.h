@@ -0,0 +1,190 @@
+/*! \file account_book.h
+    \brief File containing the BasicAccountBook class template
+
+    Storage for accounts of known concrete types, processed without virtual dispatch
+*/
+#pragma once
+
+#include "bank_account.h"
+#include "cd_account.h"
+#include "hi_checking_account.h"
+#include "hi_savings_account.h"
+#include "nosc_checking_account.h"
+#include "savings_account.h"
+#include "sc_checking_account.h"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+//! Holds accounts in one contiguous array per account type
+/*!
+  Where a container of BankAccount makes a virtual call per account, forEach runs a separate loop over each array, in
+  which every call is resolved at compile time and can be inlined. Use this for passes over many accounts, such as
+  month-end processing and reporting.
+
+  Closing an account moves the last account of the same type into its place, and inserting may reallocate, so
+  references are only valid until the next insert or close of that type.
+*/
+template <BankAccountConcept... AccountTs>
+class BasicAccountBook
+{
+public:
+    //! Refers to one account in the book, whichever type it is
+    using AccountRef = std::variant<AccountTs*...>;
+    using ConstAccountRef = std::variant<const AccountTs*...>;
+
+    //! Inserting an account number which is already in the book throws
+    template <typename AccountT>
+        requires(std::same_as<AccountT, AccountTs> || ...)
+    AccountT& insert(AccountT account) {
+        const int number = account.getAccountNumber();
+        if (index_.contains(number)) {
+            throw std::invalid_argument("An account with this number is already open");
+        }
+
+        auto& accounts = std::get<std::vector<AccountT>>(arrays_);
+        auto& stored = accounts.emplace_back(std::move(account));
+        index_.emplace(number, Location{TYPE_INDEX<AccountT>, accounts.size() - 1});
+        return stored;
+    }
+
+    //! Closes the account, returning whether one with this number was open
+    bool close(int number) {
+        auto iter = index_.find(number);
+        if (iter == index_.end()) {
+            return false;
+        }
+
+        const auto [type, position] = iter->second;
+        index_.erase(iter);
+        withArray(type, [&](auto& accounts) {
+            if (position + 1 != accounts.size()) {
+                accounts[position] = std::move(accounts.back());
+                index_[accounts[position].getAccountNumber()].position = position;
+            }
+            accounts.pop_back();
+        });
+        return true;
+    }
+
+    std::optional<AccountRef> find(int number) {
+        auto iter = index_.find(number);
+        if (iter == index_.end()) {
+            return std::nullopt;
+        }
+
+        std::optional<AccountRef> result;
+        withArray(iter->second.type, [&](auto& accounts) { result.emplace(&accounts[iter->second.position]); });
+        return result;
+    }
+    std::optional<ConstAccountRef> find(int number) const {
+        auto iter = index_.find(number);
+        if (iter == index_.end()) {
+            return std::nullopt;
+        }
+
+        std::optional<ConstAccountRef> result;
+        withArray(iter->second.type, [&](const auto& accounts) { result.emplace(&accounts[iter->second.position]); });
+        return result;
+    }
+
+    //! Calls `func` with the account of this number as its concrete type, returning whether there was one
+    template <typename Func>
+    bool visit(int number, Func&& func) {
+        auto account = find(number);
+        if (account) {
+            std::visit([&](auto* ptr) { func(*ptr); }, *account);
+        }
+        return account.has_value();
+    }
+    template <typename Func>
+    bool visit(int number, Func&& func) const {
+        auto account = find(number);
+        if (account) {
+            std::visit([&](const auto* ptr) { func(*ptr); }, *account);
+        }
+        return account.has_value();
+    }
+
+    //! Calls `func` with every account, going through all accounts of one type before moving on to the next
+    template <typename Func>
+    void forEach(Func&& func) {
+        std::apply([&](auto&... accounts) { (forEachIn(accounts, func), ...); }, arrays_);
+    }
+    template <typename Func>
+    void forEach(Func&& func) const {
+        std::apply([&](const auto&... accounts) { (forEachIn(accounts, func), ...); }, arrays_);
+    }
+
+    template <typename AccountT>
+        requires(std::same_as<AccountT, AccountTs> || ...)
+    std::span<AccountT> accounts() {
+        return std::get<std::vector<AccountT>>(arrays_);
+    }
+    template <typename AccountT>
+        requires(std::same_as<AccountT, AccountTs> || ...)
+    std::span<const AccountT> accounts() const {
+        return std::get<std::vector<AccountT>>(arrays_);
+    }
+
+    template <typename AccountT>
+        requires(std::same_as<AccountT, AccountTs> || ...)
+    void reserve(std::size_t count) {
+        std::get<std::vector<AccountT>>(arrays_).reserve(count);
+    }
+
+    std::size_t size() const { return index_.size(); }
+    bool empty() const { return index_.empty(); }
+
+private:
+    struct Location
+    {
+        std::size_t type;
+        std::size_t position;
+    };
+
+    template <typename AccountT>
+    static constexpr std::size_t TYPE_INDEX = [] {
+        constexpr std::array matches{std::same_as<AccountT, AccountTs>...};
+        return static_cast<std::size_t>(std::find(matches.begin(), matches.end(), true) - matches.begin());
+    }();
+
+    template <typename Accounts, typename Func>
+    static void forEachIn(Accounts& accounts, Func& func) {
+        for (auto& account : accounts) {
+            func(account);
+        }
+    }
+
+    //! Calls `func` with the array of accounts at `type` in the pack
+    template <typename Func>
+    void withArray(std::size_t type, Func&& func) {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((type == Is ? (func(std::get<Is>(arrays_)), true) : false) || ...);
+        }(std::index_sequence_for<AccountTs...>{});
+    }
+    template <typename Func>
+    void withArray(std::size_t type, Func&& func) const {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((type == Is ? (func(std::get<Is>(arrays_)), true) : false) || ...);
+        }(std::index_sequence_for<AccountTs...>{});
+    }
+
+    std::tuple<std::vector<AccountTs>...> arrays_;
+    std::unordered_map<int, Location> index_;
+};
+
+//! Book of the six standard account types
+using AccountBook =
+    BasicAccountBook<CertificateOfDepositAccount, SavingsAccount, HighInterestSavingsAccount,
+                     ServiceChargeCheckingAccount, NoServiceChargeCheckingAccount, HighInterestCheckingAccount>;
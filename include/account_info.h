@@ -7,12 +7,19 @@
 
 #include "money_type.h"
 #include "monthly_statement.h"
+#include "transaction.h"
+#include "util/cow_ptr.h"
 #include "util/date_util.h"
 #include "util/util.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
-#include <type_traits>
 #include <vector>
 
 //! Manages functions receiving basic information for BankAccount
@@ -22,40 +29,128 @@
 class AccountInfo
 {
 public:
+    //! Whether money can be transferred in. Account types which ignore deposits hide this with false.
+    static constexpr bool ACCEPTS_DEPOSITS = true;
+
     AccountInfo(std::string_view holderName, Money startingBalance, Date openingDate);
 
     std::string_view getAccountName() const { return holderName_; }
     int getAccountNumber() const { return number_; }
     Date getAccountOpeningDate() const { return openingDate_; }
     Money getBalance() const { return balance_; }
-    const MonthlyStatement& getMonthlyStatement(Date when) const;
-    const std::vector<MonthlyStatement>& getAllMonthlyStatements() const { return monthlyStatements_; }
+    MonthlyStatement getMonthlyStatement(Date when) const;
+    MonthlyStatementRange getAllMonthlyStatements() const {
+        std::span<const StoredStatement> stored;
+        if (monthlyStatements_) {
+            stored = *monthlyStatements_;
+        }
+        return MonthlyStatementRange{stored, openingDate_.monthIndex(), lastMonth_};
+    }
 
 protected:
     void addStatementsThrough(Date when);
     void addToMonthlyStatement(Date when, StatementRecordInfo info);
+    // The day on which the next monthly statement will need to be added
+    Date getNextStatementDate() const;
+
+    /**
+     * @brief Applies `batch` on `when` through the account's depositOn, withdrawOn and writeCheckOn.
+     *
+     * Each transaction has the same effect and record as the corresponding single call. The month's statement is
+     * looked up once and has room reserved for the whole batch. Checks are rejected before anything is applied if
+     * the account cannot write them.
+     *
+     * @return How many of the transactions succeeded, including those which incurred a penalty
+     */
+    template <typename AccountT>
+    static std::size_t applyBatch(AccountT& account, Date when, std::span<const Transaction> batch) {
+        using Type = Transaction::Type;
+
+        if constexpr (!requires { account.writeCheck(Money{}); }) {
+            if (std::any_of(batch.begin(), batch.end(), [](const auto& txn) { return txn.type == Type::Check; })) {
+                throw std::invalid_argument("Checks can only be written from checking accounts");
+            }
+        }
+
+        const auto& records = account.reserveRecords(when, batch.size());
+        std::size_t numSucceeded = 0;
+        for (const auto& transaction : batch) {
+            const auto numRecords = records.size();
+            switch (transaction.type) {
+            case Type::Deposit:
+                account.depositOn(when, transaction.amount);
+                break;
+            case Type::Withdrawal:
+                account.withdrawOn(when, transaction.amount);
+                break;
+            case Type::Check:
+                if constexpr (requires { account.writeCheck(Money{}); }) {
+                    account.writeCheckOn(when, transaction.amount);
+                }
+                break;
+            }
+
+            if (records.size() != numRecords && records.lastOn(when).succeeded()) {
+                ++numSucceeded;
+            }
+        }
+
+        return numSucceeded;
+    }
+
+    /**
+     * @brief Withdraws `amount` on `when` for a transfer to account `to`, under the same rules as withdrawOn.
+     *
+     * @return Whether the money left the account, in which case it must be passed to @ref transferIntoOn
+     */
+    template <typename AccountT>
+    static bool transferOutOn(AccountT& account, Date when, Money amount, int to) {
+        account.withdrawOn(when, amount);
+        return account.markTransfer(when, StatementRecordInfo::Event::TransferOut, to).succeeded();
+    }
+
+    //! Deposits `amount` on `when`, transferred from account `from`
+    template <typename AccountT>
+    static void transferIntoOn(AccountT& account, Date when, Money amount, int from) {
+        if constexpr (!AccountT::ACCEPTS_DEPOSITS) {
+            throw std::invalid_argument("Money cannot be transferred into this account");
+        } else {
+            account.depositOn(when, amount);
+            account.markTransfer(when, StatementRecordInfo::Event::TransferIn, from);
+        }
+    }
 
     Money balance_; // NOLINT
 
 private:
+    friend class SnapshotCodec;
+
+    //! Restores an account with its own number and history, without taking a new number or adding any records
+    AccountInfo(int number, std::string_view holderName, Money balance, Date openingDate, std::int32_t lastMonth,
+                std::vector<StoredStatement> statements);
+
     // Declared as static function to ensure thread safety
     static int generateNextAccountNum();
+    //! Makes sure no new account is given `number` or any lower number, for accounts restored with their own numbers
+    static void skipAccountNumbersThrough(int number);
 
-    template <typename SelfT>
-        requires std::is_same_v<AccountInfo, std::remove_const_t<SelfT>>
-    static util::retain_const_t<SelfT, MonthlyStatement&> getStatementHelper(SelfT& self, Date when);
+    //! The stored statement for the month containing `when`, if it has any records
+    const StoredStatement* findStatement(Date when) const;
+    //! The statement for the month containing `when`, added if it has no records yet
+    MonthlyStatement& statementFor(Date when);
+    //! The records of `when`'s month, with room for `count` more
+    const StatementRecords& reserveRecords(Date when, std::size_t count);
+    //! Turns the latest record on `when`, just added by a withdrawal or deposit, into one side of a transfer
+    const StatementRecordInfo& markTransfer(Date when, StatementRecordInfo::Event event, int counterparty);
+    //! Moves completed months beyond the limits of the active StatementArchive to it, if there is one
+    void archiveStatements();
 
     std::string holderName_;
     int number_;
     Date openingDate_;
-    std::vector<MonthlyStatement> monthlyStatements_;
+    // Only months with records are stored, ordered by month. Months up to and including `lastMonth_` exist.
+    // Copies of an account share the history, and then each statement, until they are modified, so copying is cheap
+    // however long the history is. Older months may have been archived.
+    util::CowPtr<std::vector<StoredStatement>> monthlyStatements_;
+    std::int32_t lastMonth_;
 };
-
-//! This template helps generate the monthly statements
-template <typename SelfT>
-    requires std::is_same_v<AccountInfo, std::remove_const_t<SelfT>>
-util::retain_const_t<SelfT, MonthlyStatement&> AccountInfo::getStatementHelper(SelfT& self, Date when) {
-    auto monthsSinceOpening = Date::diff<std::chrono::months>(Date{getMonthStart(self.openingDate_.get())}, when);
-
-    return self.monthlyStatements_.at(static_cast<std::size_t>(monthsSinceOpening));
-}
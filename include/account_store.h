@@ -0,0 +1,137 @@
+/*! \file account_store.h
+    \brief File containing the AccountStore class template
+
+    Storage for open accounts, looked up by account number
+*/
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//! Holds open accounts at stable addresses, with constant time lookup and closing by account number
+/*!
+  Accounts live in slots which never move, so references stay valid until that account is closed. Closing leaves an
+  empty slot behind, which is reused by the next account inserted. Iteration skips empty slots, so it visits accounts
+  in slot order rather than in the order they were opened.
+*/
+template <typename AccountT>
+class AccountStore
+{
+    template <bool IsConst>
+    class IteratorImpl;
+
+public:
+    using iterator = IteratorImpl<false>;
+    using const_iterator = IteratorImpl<true>;
+
+    //! Returns the stored account. Inserting an account number which is already open replaces nothing and throws.
+    AccountT& insert(AccountT account) {
+        const int number = account.getAccountNumber();
+        if (index_.contains(number)) {
+            throw std::invalid_argument("An account with this number is already open");
+        }
+
+        std::size_t slot{};
+        if (freeSlots_.empty()) {
+            slot = slots_.size();
+            slots_.emplace_back();
+        } else {
+            slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+
+        auto& stored = slots_[slot].emplace(std::move(account));
+        index_.emplace(number, slot);
+        return stored;
+    }
+
+    AccountT* find(int number) {
+        auto iter = index_.find(number);
+        return iter == index_.end() ? nullptr : &*slots_[iter->second];
+    }
+    const AccountT* find(int number) const {
+        auto iter = index_.find(number);
+        return iter == index_.end() ? nullptr : &*slots_[iter->second];
+    }
+
+    //! Closes the account, returning whether one with this number was open
+    bool close(int number) {
+        auto iter = index_.find(number);
+        if (iter == index_.end()) {
+            return false;
+        }
+
+        slots_[iter->second].reset();
+        freeSlots_.push_back(iter->second);
+        index_.erase(iter);
+        return true;
+    }
+
+    std::size_t size() const { return index_.size(); }
+    bool empty() const { return index_.empty(); }
+
+    iterator begin() { return iterator{slots_.begin(), slots_.end()}; }
+    iterator end() { return iterator{slots_.end(), slots_.end()}; }
+    const_iterator begin() const { return const_iterator{slots_.begin(), slots_.end()}; }
+    const_iterator end() const { return const_iterator{slots_.end(), slots_.end()}; }
+
+private:
+    using Slots = std::deque<std::optional<AccountT>>;
+
+    template <bool IsConst>
+    class IteratorImpl
+    {
+        using SlotIter = std::conditional_t<IsConst, typename Slots::const_iterator, typename Slots::iterator>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = AccountT;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const AccountT*, AccountT*>;
+        using reference = std::conditional_t<IsConst, const AccountT&, AccountT&>;
+
+        IteratorImpl() = default;
+        IteratorImpl(SlotIter current, SlotIter last)
+            : current_{current}
+            , last_{last} {
+            skipEmpty();
+        }
+
+        reference operator*() const { return **current_; }
+        pointer operator->() const { return &**current_; }
+
+        IteratorImpl& operator++() {
+            ++current_;
+            skipEmpty();
+            return *this;
+        }
+        IteratorImpl operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        bool operator==(const IteratorImpl& other) const { return current_ == other.current_; }
+
+    private:
+        void skipEmpty() {
+            while (current_ != last_ && !current_->has_value()) {
+                ++current_;
+            }
+        }
+
+        SlotIter current_{};
+        SlotIter last_{};
+    };
+
+    Slots slots_;
+    std::vector<std::size_t> freeSlots_;
+    std::unordered_map<int, std::size_t> index_;
+};
@@ -8,11 +8,15 @@
 
 #include "money_type.h"
 #include "monthly_statement.h"
+#include "transaction.h"
 #include "util/date_util.h"
+#include "util/inline_storage.h"
 
-#include <memory>
+#include <cstddef>
+#include <span>
 #include <string_view>
-#include <vector>
+#include <typeinfo>
+#include <utility>
 
 //! Concept for BankAccount to be used with the model class template
 /*!
@@ -25,47 +29,86 @@ concept BankAccountConcept = std::copyable<T> && requires(const T constAcc, T ac
     { constAcc.getAccountNumber() } -> std::convertible_to<int>;
     { constAcc.getAccountOpeningDate() } -> std::convertible_to<Date>;
     { constAcc.getBalance() } -> std::convertible_to<Money>;
-    { constAcc.getMonthlyStatement(Date{}) } -> std::same_as<const MonthlyStatement&>;
-    { constAcc.getAllMonthlyStatements() } -> std::same_as<const std::vector<MonthlyStatement>&>;
+    { constAcc.getMonthlyStatement(Date{}) } -> std::same_as<MonthlyStatement>;
+    { constAcc.getAllMonthlyStatements() } -> std::same_as<MonthlyStatementRange>;
 
     { acc.deposit(Money{}) } -> std::same_as<void>;
     { acc.withdraw(Money{}) } -> std::same_as<void>;
+    { acc.apply(std::span<const Transaction>{}) } -> std::same_as<std::size_t>;
+    { acc.transferOut(Money{}, int{}) } -> std::same_as<bool>;
+    { acc.transferIn(Money{}, int{}) } -> std::same_as<void>;
+    { T::ACCEPTS_DEPOSITS } -> std::convertible_to<bool>;
 };
 
 //! Manages basic bank account actions through multiple nested classes
 /*!
-  The base class delegates all actions to underlying accounts via a polymorphic reference to Concept
+  The base class delegates all actions to underlying accounts via a polymorphic reference to Concept. Accounts are
+  stored inside the BankAccount itself when they fit in INLINE_CAPACITY bytes, and on the heap otherwise.
 */
 class BankAccount
 {
 public:
+    //! Large enough for each of the standard account types
+    static constexpr std::size_t INLINE_CAPACITY = 160;
+    using Storage = util::InlineStorage<INLINE_CAPACITY>;
+
     template <typename AccountType>
         requires(!std::same_as<AccountType, BankAccount>) && BankAccountConcept<AccountType>
     /*implicit*/ BankAccount(const AccountType& account) // NOLINT
-        : pimpl_(std::make_unique<Model<AccountType>>(account)) {}
+        : pimpl_(storage_.construct<Model<AccountType>>(account)) {}
 
     BankAccount(const BankAccount& other)
-        : pimpl_(other.pimpl_->clone()) {}
+        : pimpl_(other.pimpl_->cloneInto(storage_)) {}
 
     BankAccount& operator=(const BankAccount& rhs) {
         if (&rhs == this) {
             return *this;
         }
-        pimpl_.reset(rhs.pimpl_.get());
+
+        BankAccount copy{rhs};
+        *this = std::move(copy);
+        return *this;
+    }
+    BankAccount(BankAccount&& other) noexcept { takeFrom(other); }
+    BankAccount& operator=(BankAccount&& rhs) noexcept {
+        if (&rhs == this) {
+            return *this;
+        }
+
+        storage_.destroy(pimpl_);
+        takeFrom(rhs);
         return *this;
     }
-    BankAccount(BankAccount&&) = default;
-    BankAccount& operator=(BankAccount&&) = default;
-    ~BankAccount() = default;
+    ~BankAccount() { storage_.destroy(pimpl_); }
+
+    //! Whether an account of this type is stored without a separate allocation
+    template <typename AccountType>
+    static constexpr bool storedInline() { return Storage::fits<Model<AccountType>>; }
 
     std::string_view getAccountName() const { return pimpl_->getAccountName(); };
     int getAccountNumber() const { return pimpl_->getAccountNumber(); };
     Date getAccountOpeningDate() const { return pimpl_->getAccountOpeningDate(); };
     Money getBalance() const { return pimpl_->getBalance(); };
-    const MonthlyStatement& getMonthlyStatement(const Date& when) const { return pimpl_->getMonthlyStatement(when); };
-    const std::vector<MonthlyStatement>& getAllMonthlyStatements() const { return pimpl_->getAllMonthlyStatements(); };
+    MonthlyStatement getMonthlyStatement(const Date& when) const { return pimpl_->getMonthlyStatement(when); };
+    MonthlyStatementRange getAllMonthlyStatements() const { return pimpl_->getAllMonthlyStatements(); };
     void deposit(const Money& amount) { pimpl_->deposit(amount); };
     void withdraw(const Money& amount) { pimpl_->withdraw(amount); };
+    //! Applies the transactions in order at the current date with a single dispatch, returning how many succeeded
+    std::size_t apply(std::span<const Transaction> batch) { return pimpl_->apply(batch); }
+    //! Withdraws `amount` as a transfer to account `to`, returning whether it succeeded
+    bool transferOut(const Money& amount, int to) { return pimpl_->transferOut(amount, to); }
+    //! Deposits `amount` transferred from account `from`, throwing std::invalid_argument if deposits are not accepted
+    void transferIn(const Money& amount, int from) { pimpl_->transferIn(amount, from); }
+    bool acceptsDeposits() const { return pimpl_->acceptsDeposits(); }
+
+    //! The account held, if it is an AccountType, like std::function::target
+    template <typename AccountType>
+    const AccountType* target() const {
+        if (pimpl_->targetType() != typeid(AccountType)) {
+            return nullptr;
+        }
+        return static_cast<const AccountType*>(pimpl_->target());
+    }
 
     //! Establishes CheckingAccount as a friend class of BankAccount
     friend class CheckingAccount;
@@ -79,47 +122,86 @@ private:
     {
     public:
         virtual ~Concept() = default;
-        virtual std::unique_ptr<Concept> clone() = 0;
+        //! Copies the account into `storage`, or onto the heap if it does not fit
+        virtual Concept* cloneInto(Storage& storage) const = 0;
+        //! Moves the account into `storage`, which it is known to fit in
+        virtual Concept* moveInto(Storage& storage) noexcept = 0;
 
         virtual std::string_view getAccountName() const = 0;
         virtual int getAccountNumber() const = 0;
         virtual Date getAccountOpeningDate() const = 0;
         virtual Money getBalance() const = 0;
-        virtual const MonthlyStatement& getMonthlyStatement(const Date& when) const = 0;
-        virtual const std::vector<MonthlyStatement>& getAllMonthlyStatements() const = 0;
+        virtual MonthlyStatement getMonthlyStatement(const Date& when) const = 0;
+        virtual MonthlyStatementRange getAllMonthlyStatements() const = 0;
         virtual void deposit(const Money& amount) = 0;
         virtual void withdraw(const Money& amount) = 0;
+        virtual std::size_t apply(std::span<const Transaction> batch) = 0;
+        virtual bool transferOut(const Money& amount, int to) = 0;
+        virtual void transferIn(const Money& amount, int from) = 0;
+        virtual bool acceptsDeposits() const = 0;
+        virtual const std::type_info& targetType() const = 0;
+        virtual const void* target() const = 0;
     };
 
-    //! Template argument for class Model inheriting from Concept inside the BankAccount class
+    //! Forwards the Concept interface to an account of type AccountType
     /*!
-      This class is nested within BankAccount and overrides the virtual functions of Concept,
-      adapting to account types with the specified type-requirements
+      Shared by BankAccount's Model and by wrappers with a wider interface, such as CheckingAccount, which derive their
+      own Concept from BankAccount's and pass it as ConceptT.
     */
-    template <BankAccountConcept AccountType>
-    class Model : public virtual Concept
+    template <BankAccountConcept AccountType, typename ConceptT>
+    class ModelBase : public ConceptT
     {
     public:
-        explicit Model(AccountType account)
+        explicit ModelBase(AccountType account)
             : impl_(std::move(account)) {}
-        std::unique_ptr<Concept> clone() override { return std::make_unique<Model>(*this); }
 
         std::string_view getAccountName() const override { return impl_.getAccountName(); };
         int getAccountNumber() const override { return impl_.getAccountNumber(); };
         Date getAccountOpeningDate() const override { return impl_.getAccountOpeningDate(); };
         Money getBalance() const override { return impl_.getBalance(); };
-        const MonthlyStatement& getMonthlyStatement(const Date& when) const override {
+        MonthlyStatement getMonthlyStatement(const Date& when) const override {
             return impl_.getMonthlyStatement(when);
         };
-        const std::vector<MonthlyStatement>& getAllMonthlyStatements() const override {
-            return impl_.getAllMonthlyStatements();
-        };
+        MonthlyStatementRange getAllMonthlyStatements() const override { return impl_.getAllMonthlyStatements(); };
         void deposit(const Money& amount) override { impl_.deposit(amount); };
         void withdraw(const Money& amount) override { impl_.withdraw(amount); };
+        std::size_t apply(std::span<const Transaction> batch) override { return impl_.apply(batch); }
+        bool transferOut(const Money& amount, int to) override { return impl_.transferOut(amount, to); }
+        void transferIn(const Money& amount, int from) override { impl_.transferIn(amount, from); }
+        bool acceptsDeposits() const override { return AccountType::ACCEPTS_DEPOSITS; }
+        const std::type_info& targetType() const override { return typeid(AccountType); }
+        const void* target() const override { return &impl_; }
 
     protected:
         AccountType impl_; // NOLINT
     };
 
-    std::unique_ptr<Concept> pimpl_;
+    //! Template argument for class Model inheriting from Concept inside the BankAccount class
+    /*!
+      This class is nested within BankAccount and overrides the virtual functions of Concept,
+      adapting to account types with the specified type-requirements.
+    */
+    template <BankAccountConcept AccountType>
+    class Model : public ModelBase<AccountType, Concept>
+    {
+    public:
+        using ModelBase<AccountType, Concept>::ModelBase;
+
+        Concept* cloneInto(Storage& storage) const override { return storage.construct<Model>(*this); }
+        Concept* moveInto(Storage& storage) noexcept override { return storage.construct<Model>(std::move(*this)); }
+    };
+
+    //! Takes over the account held by `other`, leaving it empty
+    void takeFrom(BankAccount& other) noexcept {
+        if (other.storage_.holds(other.pimpl_)) {
+            pimpl_ = other.pimpl_->moveInto(storage_);
+            other.storage_.destroy(other.pimpl_);
+        } else {
+            pimpl_ = other.pimpl_;
+        }
+        other.pimpl_ = nullptr;
+    }
+
+    Storage storage_;
+    Concept* pimpl_ = nullptr;
 };
@@ -0,0 +1,71 @@
+/*! \file batch_runner.h
+    \brief File containing the BatchRunner class
+
+    Running a script of account commands without prompts, for driving large scenarios
+*/
+#pragma once
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "statement_renderer.h"
+#include "transaction.h"
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+//! Runs account commands read from a script, one per line, writing plain text results
+/*!
+  Words on a line are separated by spaces, and may be quoted to contain them. Blank lines and lines starting with `#`
+  are skipped. The commands are:
+
+  - `open <alias> <type> <holder> <balance> [<rate> [<months> <penalty>]]` opens an account, where the type is one of
+    `cd`, `checking`, `sc-checking`, `hi-checking`, `savings` or `hi-savings`. Every type but `sc-checking` takes a
+    monthly interest rate, and `cd` also takes its months to maturity and early withdrawal penalty.
+  - `step <days>` moves the simulated date forward
+  - `deposit`, `withdraw` or `check` followed by `<account> <amount>`
+  - `close <account>`, `info <account>` and `statement <account>`
+  - `import <file>` applies a CSV file of transactions, see importTransactions
+  - `export <file>` writes the statements of every open account, see exportStatements
+
+  An `<account>` is either the alias given to `open`, which may be reused once the account is closed, or an account
+  number. Amounts are read by parseMoney, such as `1234.56` or `"$1,234.56"`. A command which fails is reported with
+  its line number, and the script carries on.
+
+  Results are written to a buffer, which is only written to the output once it holds about `bufferSize` bytes and when
+  a script ends, so the output sees few large writes.
+*/
+class BatchRunner
+{
+public:
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE = std::size_t{1} << 20;
+
+    //! Runs commands against `accounts`, writing their results to `output`
+    BatchRunner(AccountStore<BankAccount>& accounts, std::ostream& output,
+                std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+    //! Runs every command of `script`, returning how many failed
+    std::size_t run(std::string_view script);
+    //! Runs every command read from `input` until it ends, returning how many failed
+    std::size_t run(std::istream& input);
+
+private:
+    //! Runs one command split into words, throwing if it fails
+    void execute(std::span<const std::string_view> words);
+    void open(std::span<const std::string_view> words);
+    void transact(std::span<const std::string_view> words, Transaction::Type type);
+    //! Finds the open account named by an alias or number, throwing std::invalid_argument if there is none
+    BankAccount& account(std::string_view name);
+    void flush();
+
+    AccountStore<BankAccount>& accounts_;
+    std::ostream& output_;
+    std::size_t bufferSize_;
+    std::unordered_map<std::string, int> aliases_;
+    // Also used for formatting every other result
+    StatementRenderer renderer_;
+};
@@ -3,8 +3,13 @@
 #include "account_info.h"
 #include "bank_account.h"
 #include "interest_handler.h"
+#include "transaction.h"
 #include "util/date_util.h"
 
+#include <cstddef>
+#include <span>
+#include <utility>
+
 class CertificateOfDepositAccount : public AccountInfo
 {
 public:
@@ -20,12 +25,12 @@ public:
      * @param timeManager
      */
     CertificateOfDepositAccount(std::string_view holderName, Money startingBalance,
-                                std::chrono::months numMaturityMonths, double earlyWithdrawalPenalty,
+                                std::chrono::months numMaturityMonths, Rate earlyWithdrawalPenalty,
                                 const InterestHandler& interestHandler, TimeManager auto timeManager = {});
     CertificateOfDepositAccount(const CertificateOfDepositAccount& other);
-    CertificateOfDepositAccount(CertificateOfDepositAccount&&) = default;
+    CertificateOfDepositAccount(CertificateOfDepositAccount&& other) noexcept;
     CertificateOfDepositAccount& operator=(const CertificateOfDepositAccount& rhs);
-    CertificateOfDepositAccount& operator=(CertificateOfDepositAccount&&) = default;
+    CertificateOfDepositAccount& operator=(CertificateOfDepositAccount&& rhs) noexcept;
     ~CertificateOfDepositAccount() = default;
 
     /**
@@ -35,22 +40,38 @@ public:
      */
     void deposit(Money /*amount*/);
     void withdraw(Money amount);
+    std::size_t apply(std::span<const Transaction> batch);
+    bool transferOut(Money amount, int to);
+    //! Always throws std::invalid_argument, see ACCEPTS_DEPOSITS
+    void transferIn(Money amount, int from);
+
+    static constexpr bool ACCEPTS_DEPOSITS = false;
 
 protected:
     void update(DatePeriod period);
+    Date getNextEventDate() const;
 
 private:
+    friend class AccountInfo;
+    friend class SnapshotCodec;
+
+    //! Restores an account read by SnapshotCodec, which then sets the rest of its state
+    CertificateOfDepositAccount(AccountInfo&& info, const InterestHandler& interestHandler,
+                                TimeManager auto timeManager);
+
+    void depositOn(Date /*when*/, Money /*amount*/);
+    void withdrawOn(Date when, Money amount);
     int numMaturityMonths_;
     bool isMature_{false};
     InterestHandler interestHandler_;
-    double earlyWithdrawalPenalty_;
+    Rate earlyWithdrawalPenalty_;
     Date lastInterestPayment_;
     TimeManagerResource timeManager_;
 };
 
 CertificateOfDepositAccount::CertificateOfDepositAccount(std::string_view holderName, Money startingBalance,
                                                          std::chrono::months numMaturityMonths,
-                                                         double earlyWithdrawalPenalty,
+                                                         Rate earlyWithdrawalPenalty,
                                                          const InterestHandler& interestHandler,
                                                          TimeManager auto timeManager)
     : AccountInfo(holderName, startingBalance, timeManager.getDate())
@@ -59,10 +80,19 @@ CertificateOfDepositAccount::CertificateOfDepositAccount(std::string_view holder
     , earlyWithdrawalPenalty_{earlyWithdrawalPenalty}
     , lastInterestPayment_{getAccountOpeningDate()}
     , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {
-    addToMonthlyStatement(timeManager.getDate(), {.details = "Account opened",
+    addToMonthlyStatement(timeManager.getDate(), {.event = StatementRecordInfo::Event::AccountOpened,
                                                   .balanceChange = getBalance(),
                                                   .changeType = StatementRecordInfo::None,
                                                   .resultantBalance = getBalance()});
 }
 
+CertificateOfDepositAccount::CertificateOfDepositAccount(AccountInfo&& info, const InterestHandler& interestHandler,
+                                                         TimeManager auto timeManager)
+    : AccountInfo(std::move(info))
+    , numMaturityMonths_{0}
+    , interestHandler_{interestHandler}
+    , earlyWithdrawalPenalty_{0.0}
+    , lastInterestPayment_{getAccountOpeningDate()}
+    , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {}
+
 static_assert(BankAccountConcept<CertificateOfDepositAccount>);
@@ -9,11 +9,13 @@
 #include "bank_account.h"
 #include "money_type.h"
 #include "monthly_statement.h"
+#include "transaction.h"
 #include "util/date_util.h"
 
-#include <memory>
+#include <cstddef>
+#include <span>
 #include <string_view>
-#include <vector>
+#include <utility>
 
 //! Concept for CheckingAccount to be used with the Model class template
 /*!
@@ -31,34 +33,55 @@ concept CheckingAccountConcept = BankAccountConcept<T> && requires(T acc) {
 class CheckingAccount
 {
 public:
+    using Storage = BankAccount::Storage;
+
     template <typename AccountType>
         requires(!std::same_as<AccountType, CheckingAccount>) && CheckingAccountConcept<AccountType>
     /*implicit*/ CheckingAccount(const AccountType& account) // NOLINT
-        : pimpl_(std::make_unique<Model<AccountType>>(account)) {}
+        : pimpl_(storage_.construct<Model<AccountType>>(account)) {}
 
     CheckingAccount(const CheckingAccount& other)
-        : pimpl_(dynamic_cast<Concept*>(other.pimpl_->clone().release())) {}
+        : pimpl_(other.pimpl_->cloneInto(storage_)) {}
 
     CheckingAccount& operator=(const CheckingAccount& rhs) {
         if (&rhs == this) {
             return *this;
         }
-        pimpl_.reset(rhs.pimpl_.get());
+
+        CheckingAccount copy{rhs};
+        *this = std::move(copy);
+        return *this;
+    }
+    CheckingAccount(CheckingAccount&& other) noexcept { takeFrom(other); }
+    CheckingAccount& operator=(CheckingAccount&& rhs) noexcept {
+        if (&rhs == this) {
+            return *this;
+        }
+
+        storage_.destroy(pimpl_);
+        takeFrom(rhs);
         return *this;
     }
-    CheckingAccount(CheckingAccount&&) = default;
-    CheckingAccount& operator=(CheckingAccount&&) = default;
-    ~CheckingAccount() = default;
+    ~CheckingAccount() { storage_.destroy(pimpl_); }
+
+    //! Whether an account of this type is stored without a separate allocation
+    template <typename AccountType>
+    static constexpr bool storedInline() { return Storage::fits<Model<AccountType>>; }
 
     std::string_view getAccountName() const { return pimpl_->getAccountName(); };
     int getAccountNumber() const { return pimpl_->getAccountNumber(); };
     Date getAccountOpeningDate() const { return pimpl_->getAccountOpeningDate(); };
     Money getBalance() const { return pimpl_->getBalance(); };
-    const MonthlyStatement& getMonthlyStatement(const Date& when) const { return pimpl_->getMonthlyStatement(when); };
-    const std::vector<MonthlyStatement>& getAllMonthlyStatements() const { return pimpl_->getAllMonthlyStatements(); };
+    MonthlyStatement getMonthlyStatement(const Date& when) const { return pimpl_->getMonthlyStatement(when); };
+    MonthlyStatementRange getAllMonthlyStatements() const { return pimpl_->getAllMonthlyStatements(); };
     void deposit(const Money& amount) { pimpl_->deposit(amount); };
     void withdraw(const Money& amount) { pimpl_->withdraw(amount); };
     void writeCheck(const Money& amount) { pimpl_->writeCheck(amount); };
+    //! Applies the transactions in order at the current date with a single dispatch, returning how many succeeded
+    std::size_t apply(std::span<const Transaction> batch) { return pimpl_->apply(batch); }
+    bool transferOut(const Money& amount, int to) { return pimpl_->transferOut(amount, to); }
+    void transferIn(const Money& amount, int from) { pimpl_->transferIn(amount, from); }
+    bool acceptsDeposits() const { return pimpl_->acceptsDeposits(); }
 
 private:
     //! Abstract class inheriting from BankAccount
@@ -66,28 +89,42 @@ private:
       The abstract class Concept inherits member functions from BankAccount and adds a new member function called
       writeCheck
     */
-    class Concept : public virtual BankAccount::Concept
+    class Concept : public BankAccount::Concept
     {
     public:
+        Concept* cloneInto(Storage& storage) const override = 0;
+        Concept* moveInto(Storage& storage) noexcept override = 0;
+
         virtual void writeCheck(const Money& amount) = 0;
     };
 
-    //! Template argument for CheckingAccountConcept inheriting from Concept and BankAccount
+    //! Template argument for CheckingAccountConcept inheriting from Concept
     /*!
-      This class is nested within CheckingAccount and overrides the Concept class as well while inheriting
-      from BankAccount the same as COncept does
+      This class is nested within CheckingAccount, reusing BankAccount's forwarding for everything apart from writeCheck
     */
     template <CheckingAccountConcept AccountType>
-    class Model : public Concept, public BankAccount::Model<AccountType>
+    class Model : public BankAccount::ModelBase<AccountType, Concept>
     {
     public:
-        explicit Model(const AccountType& account)
-            : BankAccount::Model<AccountType>(account) {}
+        using BankAccount::ModelBase<AccountType, Concept>::ModelBase;
 
-        std::unique_ptr<BankAccount::Concept> clone() override { return std::make_unique<Model>(*this); };
+        Concept* cloneInto(Storage& storage) const override { return storage.construct<Model>(*this); }
+        Concept* moveInto(Storage& storage) noexcept override { return storage.construct<Model>(std::move(*this)); }
 
-        void writeCheck(const Money& amount) override { BankAccount::Model<AccountType>::impl_.writeCheck(amount); };
+        void writeCheck(const Money& amount) override { this->impl_.writeCheck(amount); };
     };
 
-    std::unique_ptr<Concept> pimpl_;
+    //! Takes over the account held by `other`, leaving it empty
+    void takeFrom(CheckingAccount& other) noexcept {
+        if (other.storage_.holds(other.pimpl_)) {
+            pimpl_ = other.pimpl_->moveInto(storage_);
+            other.storage_.destroy(other.pimpl_);
+        } else {
+            pimpl_ = other.pimpl_;
+        }
+        other.pimpl_ = nullptr;
+    }
+
+    Storage storage_;
+    Concept* pimpl_ = nullptr;
 };
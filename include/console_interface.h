@@ -1,16 +1,28 @@
 #pragma once
 
+#include "account_store.h"
 #include "bank_account.h"
+#include "journal.h"
+#include "statement_renderer.h"
 
-#include <vector>
+#include <filesystem>
+#include <optional>
 
 class ConsoleInterface
 {
 public:
+    ConsoleInterface() = default;
+    //! Starts from the snapshot at `snapshotPath` if there is one, and saves to it on quitting
+    /*!
+      Operations are also journaled next to the snapshot, and replayed on top of it when starting, so nothing is lost if
+      the program stops without quitting.
+    */
+    explicit ConsoleInterface(std::filesystem::path snapshotPath);
+
     void run();
 
 private:
-    enum class MainMenuOption { NewAccount, StepDays, SelectAccount, Quit };
+    enum class MainMenuOption { NewAccount, StepDays, SelectAccount, ExportStatements, Quit };
     enum class AccountMenuOption { Close, DisplayStatement, Info, Deposit, Withdraw, Back };
 
     static MainMenuOption mainMenu();
@@ -19,6 +31,11 @@ private:
     void handleAccountAction(AccountMenuOption opt, BankAccount& account);
     BankAccount* selectAccount();
     void newAccount();
+    void exportAllStatements() const;
 
-    std::vector<BankAccount> openAccounts_;
+    AccountStore<BankAccount> openAccounts_;
+    std::optional<std::filesystem::path> snapshotPath_;
+    std::optional<Journal> journal_;
+    // Kept between displays, so showing statements reuses its memory
+    StatementRenderer statementRenderer_;
 };
@@ -4,8 +4,13 @@
 #include "bank_account.h"
 #include "checking_account.h"
 #include "interest_handler.h"
+#include "transaction.h"
 #include "util/date_util.h"
 
+#include <cstddef>
+#include <span>
+#include <utility>
+
 // Due to the nature of type erasure as it's used on these classes,
 // most of the code here corresponds one-to-one with `NoServiceChargeCheckingAccount`
 // as previously was reused via inheritance.
@@ -16,21 +21,35 @@ public:
     HighInterestCheckingAccount(std::string_view holderName, Money startingBalance,
                                 const InterestHandler& interestHandler, TimeManager auto timeManager = {});
     HighInterestCheckingAccount(const HighInterestCheckingAccount& other);
-    HighInterestCheckingAccount(HighInterestCheckingAccount&&) = default;
+    HighInterestCheckingAccount(HighInterestCheckingAccount&& other) noexcept;
     HighInterestCheckingAccount& operator=(const HighInterestCheckingAccount& rhs);
-    HighInterestCheckingAccount& operator=(HighInterestCheckingAccount&&) = default;
+    HighInterestCheckingAccount& operator=(HighInterestCheckingAccount&& rhs) noexcept;
     ~HighInterestCheckingAccount() = default;
 
     void deposit(Money amount);
     void withdraw(Money amount);
     void writeCheck(Money amount);
+    std::size_t apply(std::span<const Transaction> batch);
+    bool transferOut(Money amount, int to);
+    void transferIn(Money amount, int from);
 
 private:
+    friend class AccountInfo;
+    friend class SnapshotCodec;
+
+    //! Restores an account read by SnapshotCodec, which then sets the rest of its state
+    HighInterestCheckingAccount(AccountInfo&& info, const InterestHandler& interestHandler,
+                                TimeManager auto timeManager);
+
+    void depositOn(Date when, Money amount);
+    void withdrawOn(Date when, Money amount);
+    void writeCheckOn(Date when, Money amount);
     void update(DatePeriod period);
-    void withdrawHelper(Money amount, std::string_view action);
+    Date getNextEventDate() const;
+    void withdrawHelper(Date when, Money amount, StatementRecordInfo::Event action);
 
     constexpr static Money MIN_BALANCE = 500_dollars;
-    constexpr static double INTEREST_MULTIPLIER = 2.5;
+    constexpr static Rate INTEREST_MULTIPLIER = 2.5;
 
     InterestHandler interestHandler_;
     TimeManagerResource timeManager_;
@@ -42,11 +61,17 @@ HighInterestCheckingAccount::HighInterestCheckingAccount(std::string_view holder
     : AccountInfo(holderName, startingBalance, timeManager.getDate())
     , interestHandler_(interestHandler)
     , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {
-    addToMonthlyStatement(timeManager.getDate(), {.details = "Account opened",
+    addToMonthlyStatement(timeManager.getDate(), {.event = StatementRecordInfo::Event::AccountOpened,
                                                   .balanceChange = getBalance(),
                                                   .changeType = StatementRecordInfo::None,
                                                   .resultantBalance = getBalance()});
 }
 
+HighInterestCheckingAccount::HighInterestCheckingAccount(AccountInfo&& info, const InterestHandler& interestHandler,
+                                                         TimeManager auto timeManager)
+    : AccountInfo(std::move(info))
+    , interestHandler_(interestHandler)
+    , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {}
+
 static_assert(BankAccountConcept<HighInterestCheckingAccount>);
 static_assert(CheckingAccountConcept<HighInterestCheckingAccount>);
@@ -4,6 +4,11 @@
 #include "bank_account.h"
 #include "interest_handler.h"
 #include "money_type.h"
+#include "transaction.h"
+
+#include <cstddef>
+#include <span>
+#include <utility>
 
 // Due to the nature of type erasure as it's used on these classes,
 // most of the code here corresponds one-to-one with `SavingsAccount`
@@ -15,18 +20,31 @@ public:
     HighInterestSavingsAccount(std::string_view holderName, Money startingBalance,
                                const InterestHandler& interestHandler, TimeManager auto timeManager = {});
     HighInterestSavingsAccount(const HighInterestSavingsAccount& other);
-    HighInterestSavingsAccount(HighInterestSavingsAccount&&) = default;
+    HighInterestSavingsAccount(HighInterestSavingsAccount&& other) noexcept;
     HighInterestSavingsAccount& operator=(const HighInterestSavingsAccount& rhs);
-    HighInterestSavingsAccount& operator=(HighInterestSavingsAccount&&) = default;
+    HighInterestSavingsAccount& operator=(HighInterestSavingsAccount&& rhs) noexcept;
     ~HighInterestSavingsAccount() = default;
 
     void deposit(Money amount);
     void withdraw(Money amount);
+    std::size_t apply(std::span<const Transaction> batch);
+    bool transferOut(Money amount, int to);
+    void transferIn(Money amount, int from);
 
 private:
+    friend class AccountInfo;
+    friend class SnapshotCodec;
+
+    //! Restores an account read by SnapshotCodec, which then sets the rest of its state
+    HighInterestSavingsAccount(AccountInfo&& info, const InterestHandler& interestHandler,
+                               TimeManager auto timeManager);
+
+    void depositOn(Date when, Money amount);
+    void withdrawOn(Date when, Money amount);
     void update(DatePeriod period);
+    Date getNextEventDate() const;
 
-    constexpr static double INTEREST_MULTIPLIER = 2.5;
+    constexpr static Rate INTEREST_MULTIPLIER = 2.5;
     constexpr static Money MIN_BALANCE = 10'000_dollars;
 
     InterestHandler interestHandler_;
@@ -39,10 +57,16 @@ HighInterestSavingsAccount::HighInterestSavingsAccount(std::string_view holderNa
     : AccountInfo(holderName, startingBalance, timeManager.getDate())
     , interestHandler_(interestHandler)
     , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {
-    addToMonthlyStatement(timeManager.getDate(), {.details = "Account opened",
+    addToMonthlyStatement(timeManager.getDate(), {.event = StatementRecordInfo::Event::AccountOpened,
                                                   .balanceChange = getBalance(),
                                                   .changeType = StatementRecordInfo::None,
                                                   .resultantBalance = getBalance()});
 }
 
+HighInterestSavingsAccount::HighInterestSavingsAccount(AccountInfo&& info, const InterestHandler& interestHandler,
+                                                       TimeManager auto timeManager)
+    : AccountInfo(std::move(info))
+    , interestHandler_(interestHandler)
+    , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {}
+
 static_assert(BankAccountConcept<HighInterestSavingsAccount>);
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "fmt/core.h"
+#include "money_type.h"
 #include "util/date_util.h"
+#include <chrono>
 #include <functional>
 #include <string_view>
 
@@ -11,17 +13,22 @@ enum class InterestType { Daily, Monthly, Quarterly, Yearly };
 class InterestHandler
 {
 public:
-    InterestHandler(InterestType compoundingPeriod, double rate);
+    InterestHandler(InterestType compoundingPeriod, Rate rate);
 
-    void processDuring(Date begin, Date end, const std::function<void(Date, double)>& interestPayoutFn);
+    void processDuring(Date begin, Date end, const std::function<void(Date, Rate)>& interestPayoutFn);
 
-    double getRate() const { return rate_; }
+    double getRate() const { return static_cast<double>(rate_); }
+
+    //! The first day on which a payout could be made, or an invalid date if none have been processed yet
+    Date getNextPayoutDate() const;
 
 private:
-    void tryProcessOn(Date day, const std::function<void(Date, double)>& interestPayoutFn);
+    friend class SnapshotCodec;
+
+    std::chrono::days getPeriodLength() const;
 
     InterestType compoundingPeriod_;
-    double rate_;
+    Rate rate_;
 
     Date lastPayment_;
 };
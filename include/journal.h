@@ -0,0 +1,116 @@
+/*! \file journal.h
+    \brief File containing the Journal class
+
+    Recording account operations to a file as they happen, so they survive between snapshots
+*/
+#pragma once
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "transaction.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Append-only log of account operations, written out in batches by a background thread
+/*!
+  Recording an operation only copies a fixed size record into a buffer and returns. The background thread writes out
+  everything buffered and syncs it to disk in one go, at most @ref Options::maxDelay after the first record of the
+  batch, so many operations share each sync. Call @ref sync to wait until everything recorded so far is on disk.
+
+  Every record is numbered. A snapshot stores the number of the last record it includes, and @ref replay applies only
+  the records after it, so nothing is applied twice if the journal was not emptied by @ref checkpoint after writing the
+  snapshot.
+
+  Records are checksummed, and reading stops at the first one which is incomplete or damaged, as the last batch may
+  have been cut short by a crash. Recording is safe from any thread, but operations on the same account must be
+  recorded in the order they are applied.
+*/
+class Journal
+{
+public:
+    struct Options
+    {
+        //! Longest a record is buffered before being written out
+        std::chrono::microseconds maxDelay{2000};
+        //! Capacity of each of the two buffers. Recording waits while both are in use.
+        std::size_t bufferSize = std::size_t{256} << 10U;
+    };
+
+    //! Opens the journal at `path`, creating it if there is none yet
+    /*!
+      Throws std::runtime_error if the file cannot be opened or is not a journal. Anything after the last intact
+      record is cut off.
+    */
+    explicit Journal(const std::filesystem::path& path);
+    Journal(const std::filesystem::path& path, Options options);
+    Journal(const Journal&) = delete;
+    Journal(Journal&&) = delete;
+    Journal& operator=(const Journal&) = delete;
+    Journal& operator=(Journal&&) = delete;
+    //! Writes out everything still buffered
+    ~Journal();
+
+    //! Applies every record numbered after `afterSequence` to `accounts`, returning how many were applied
+    /*!
+      Time steps advance SimTimeManager and update every account, as the console does. To be called before recording
+      anything, with the journal sequence of the snapshot `accounts` were loaded from. Throws std::runtime_error if a
+      record refers to an account which is not open.
+    */
+    std::size_t replay(AccountStore<BankAccount>& accounts, std::uint64_t afterSequence = 0);
+
+    // Each is recorded before the operation is applied, except opening which records the opened account
+    void record(int number, const Transaction& transaction);
+    void recordTimeStep(std::chrono::days days);
+    void recordOpened(const BankAccount& account);
+    void recordClosed(int number);
+
+    //! Number of the latest record, to store in a snapshot which includes everything recorded so far
+    std::uint64_t lastSequence() const;
+    //! Blocks until every record so far is on disk. Throws std::runtime_error if writing the journal failed.
+    void sync();
+    //! Empties the journal if `snapshotSequence` is still the latest record, returning whether it did
+    /*!
+      To be called once a snapshot including every record up to `snapshotSequence` is durably on disk, as it is once
+      writeSnapshot returns. Emptying the journal any earlier would lose those records if the snapshot did not survive a
+      crash. Anything recorded since then is kept, so the journal is only emptied once a later snapshot includes it.
+    */
+    bool checkpoint(std::uint64_t snapshotSequence);
+
+private:
+    void append(std::uint8_t type, int number, std::uint64_t value, std::span<const std::byte> payload = {});
+    //! Blocks until everything buffered is on disk, with the lock held by `lock`
+    void waitForFlush(std::unique_lock<std::mutex>& lock);
+    void throwIfFailed() const;
+
+    void flusherLoop();
+    void writeOut(const std::vector<std::byte>& bytes, std::uint64_t offset) const;
+
+    std::filesystem::path path_;
+    Options options_;
+    int fd_ = -1;
+
+    mutable std::mutex mutex_;
+    std::condition_variable flushNeeded_;
+    std::condition_variable flushed_;
+    std::vector<std::byte> active_;
+    std::vector<std::byte> flushing_;
+    std::chrono::steady_clock::time_point batchStart_;
+    std::uint64_t fileSize_ = 0;
+    std::uint64_t lastSequence_ = 0;
+    std::uint64_t durableSequence_ = 0;
+    // Threads waiting for a flush, which is then started without waiting out maxDelay
+    std::size_t numWaiting_ = 0;
+    bool stopping_ = false;
+    std::string error_;
+
+    std::thread flusher_;
+};
@@ -3,57 +3,148 @@
 #include "util/util.h"
 
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <compare>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
 #include <fmt/format.h>
 #include <locale>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
-// Only supports USD for now
+// Exact fixed-point ratio, such as an interest rate or a multiplier, stored in millionths
+class Rate
+{
+public:
+    static constexpr std::int64_t SCALE = 1'000'000;
+
+    constexpr Rate() = default;
+    // Rounded to the nearest millionth
+    /*implicit*/ constexpr Rate(double rate) // NOLINT
+        : millionths_{static_cast<std::int64_t>(rate * static_cast<double>(SCALE) + (rate < 0 ? -0.5 : 0.5))} {}
+
+    static constexpr Rate fromMillionths(std::int64_t millionths) {
+        Rate rate;
+        rate.millionths_ = millionths;
+        return rate;
+    }
+    static constexpr Rate fromBasisPoints(std::int64_t basisPoints) { return fromMillionths(basisPoints * 100); }
+
+    constexpr std::int64_t millionths() const { return millionths_; }
+    explicit constexpr operator double() const {
+        return static_cast<double>(millionths_) / static_cast<double>(SCALE);
+    }
+
+    constexpr Rate operator+(Rate rhs) const { return fromMillionths(millionths_ + rhs.millionths_); }
+    constexpr Rate operator-(Rate rhs) const { return fromMillionths(millionths_ - rhs.millionths_); }
+    // Rounded to the nearest millionth, ties to even
+    constexpr Rate operator*(Rate rhs) const {
+        const std::int64_t product = millionths_ * rhs.millionths_;
+        std::int64_t result = product / SCALE;
+        const std::int64_t remainder = product % SCALE;
+        const std::int64_t twiceRemainder = 2 * (remainder < 0 ? -remainder : remainder);
+
+        if (twiceRemainder > SCALE || (twiceRemainder == SCALE && result % 2 != 0)) {
+            result += product < 0 ? -1 : 1;
+        }
+
+        return fromMillionths(result);
+    }
+
+    std::strong_ordering operator<=>(const Rate& rhs) const = default;
+    bool operator==(const Rate& rhs) const = default;
+
+private:
+    std::int64_t millionths_ = 0;
+};
+
+// Only supports USD for now.
+// Amounts are held as a single count of cents, so arithmetic and comparisons are plain integer operations.
 class Money
 {
 public:
     constexpr Money() = default;
     constexpr Money(int dollars, int cents) // NOLINT(*easily-swappable-parameters)
-        : dollars_{static_cast<uint64_t>(dollars)}
-        , cents_{static_cast<uint64_t>(cents)} {
-        handleChange();
+        : cents_{static_cast<std::uint64_t>(dollars) * 100 + static_cast<std::uint64_t>(cents)} {
         util::ctassert(dollars >= 0, "Dollars must be positive");
         util::ctassert(cents >= 0, "Cents must be positive");
     }
 
-    constexpr std::uint64_t dollars() const { return dollars_; }
-    constexpr std::uint64_t cents() const { return cents_; }
+    static constexpr Money fromCents(std::uint64_t cents) {
+        Money amount;
+        amount.cents_ = cents;
+        return amount;
+    }
 
-    explicit operator std::string() const { return fmt::format("${}.{:02}", util::CommaSeperated{dollars_}, cents_); }
+    constexpr std::uint64_t dollars() const { return cents_ / 100; }
+    constexpr std::uint64_t cents() const { return cents_ % 100; }
+    constexpr std::uint64_t totalCents() const { return cents_; }
+
+    //! Longest text an amount is written as, such as `$1,234.56`
+    static constexpr std::size_t MAX_CHARS = util::MAX_GROUPED_CHARS + 4;
+    using CharBuffer = std::array<char, MAX_CHARS>;
+
+    //! Writes the amount to the end of `buffer`, returning the part written
+    constexpr std::string_view toChars(CharBuffer& buffer) const {
+        char* const end = buffer.data() + buffer.size();
+        char* start = util::writeDigitPair(cents(), end);
+        *--start = '.'; // NOLINT(*pointer-arithmetic)
+        start = util::writeGrouped(dollars(), start);
+        *--start = '$'; // NOLINT(*pointer-arithmetic)
+        return {start, static_cast<std::size_t>(end - start)};
+    }
+
+    explicit operator std::string() const {
+        CharBuffer buffer{};
+        return std::string{toChars(buffer)};
+    }
 
     constexpr Money operator+(const Money& rhs) const { return Money{*this} += rhs; }
     constexpr Money& operator+=(const Money& rhs) {
-        dollars_ += rhs.dollars_;
         cents_ += rhs.cents_;
-        handleChange();
         return *this;
     }
     constexpr Money operator-(Money rhs) const { return Money{*this} -= rhs; }
     constexpr Money& operator-=(const Money& rhs) {
-        dollars_ -= rhs.dollars_;
         cents_ -= rhs.cents_;
-        handleChange();
         return *this;
     }
 
-    constexpr Money operator*(Money rhs) const { return Money{*this} *= rhs; }
-    constexpr Money& operator*=(const Money& rhs) {
-        dollars_ *= rhs.dollars_;
-        cents_ *= rhs.cents_;
-        handleChange();
+    template <std::integral IntType>
+    constexpr Money operator*(IntType rhs) const {
+        return Money{*this} *= rhs;
+    }
+    template <std::integral IntType>
+    constexpr Money& operator*=(IntType rhs) {
+        if constexpr (std::is_signed_v<IntType>) {
+            util::ctassert(rhs >= 0, "Cannot multiply an amount by a negative number");
+        }
+        cents_ *= static_cast<std::uint64_t>(rhs);
         return *this;
     }
-    constexpr Money operator*(double rhs) const { return Money{*this} *= rhs; }
-    constexpr Money& operator*=(double rhs) {
-        dollars_ = static_cast<std::uint64_t>(static_cast<double>(dollars_) * rhs);
-        cents_ = static_cast<std::uint64_t>(static_cast<double>(cents_) * rhs);
-        handleChange();
+    constexpr Money operator*(double rhs) const { return Money{*this} *= Rate{rhs}; }
+    constexpr Money& operator*=(double rhs) { return *this *= Rate{rhs}; }
+    constexpr Money operator*(Rate rhs) const { return Money{*this} *= rhs; }
+    // Rounded to the nearest cent, ties to even
+    constexpr Money& operator*=(Rate rhs) {
+        util::ctassert(rhs.millionths() >= 0, "Cannot multiply an amount by a negative rate");
+
+        // Split the amount so that the intermediate products stay within 64 bits
+        const auto scale = static_cast<std::uint64_t>(Rate::SCALE);
+        const auto rate = static_cast<std::uint64_t>(rhs.millionths());
+        const std::uint64_t whole = cents_ / scale;
+        const std::uint64_t fraction = (cents_ % scale) * rate;
+        const std::uint64_t remainder = fraction % scale;
+
+        cents_ = whole * rate + fraction / scale;
+        if (2 * remainder > scale || (2 * remainder == scale && cents_ % 2 != 0)) {
+            ++cents_;
+        }
+
         return *this;
     }
 
@@ -61,26 +152,30 @@ public:
     bool operator==(const Money& rhs) const = default;
 
 private:
-    constexpr void handleChange() {
-        if (cents_ < 100) {
-            return;
-        }
-
-        dollars_ += cents_ / 100;
-        cents_ %= 100;
-    }
-
-    std::uint64_t dollars_ = 0;
     std::uint64_t cents_ = 0;
 };
 
+static_assert(sizeof(Money) == sizeof(std::uint64_t));
+
+//! Parses an amount such as `$1,234,567.89`, `1234567.89` or `12.5` from the start of `text`, like std::from_chars
+/*!
+  The dollar sign is optional, and commas are only accepted between complete groups of three digits. At most two
+  decimal places are read, one meaning tenths of a dollar.
+
+  On success `value` is set, and the returned pointer is past the amount, which may stop short of the end of `text`.
+  Otherwise `value` is left as it was and the error is std::errc::invalid_argument if `text` does not start with an
+  amount, or std::errc::result_out_of_range if the amount is too large.
+*/
+std::from_chars_result parseMoney(std::string_view text, Money& value);
+
 constexpr Money operator""_dollars(const char* str) {
     // NOLINTBEGIN
     auto dollars = util::atoi(str);
 
-    const char* decPoint = std::find(str, str + util::strlen(str), '.');
+    const char* end = str + util::strlen(str);
+    const char* decPoint = std::find(str, end, '.');
 
-    if (decPoint == nullptr || util::strlen(decPoint + 1) == 0) {
+    if (decPoint == end || util::strlen(decPoint + 1) == 0) {
         return Money{dollars, 0};
     }
 
@@ -90,6 +185,11 @@ constexpr Money operator""_dollars(const char* str) {
         throw std::runtime_error("More than 2 decimal places");
     }
 
+    // A single decimal place is in tenths of a dollar
+    if (util::strlen(decPoint + 1) == 1) {
+        cents *= 10;
+    }
+
     return Money{dollars, cents};
     // NOLINTEND
 }
@@ -107,10 +207,11 @@ constexpr Money operator""_cents(unsigned long long amount) {
 }
 
 template <>
-struct fmt::formatter<Money> : formatter<std::string>
+struct fmt::formatter<Money> : formatter<std::string_view>
 {
     template <class FmtContext>
     FmtContext::iterator format(Money amt, FmtContext& ctx) const {
-        return fmt::formatter<std::string>::format(std::string{amt}, ctx);
+        Money::CharBuffer buffer{};
+        return fmt::formatter<std::string_view>::format(amt.toChars(buffer), ctx);
     }
 };
@@ -2,36 +2,374 @@
 
 #include "fmt/core.h"
 #include "money_type.h"
+#include "util/cow_ptr.h"
 #include "util/date_util.h"
 #include <fmt/format.h>
-#include <map>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+/**
+ * @brief A single statement entry, stored as an event code and its parameters.
+ *
+ * The description shown on a statement is only rendered when the record is formatted.
+ */
 struct StatementRecordInfo
 {
-    std::string details;
+    enum class Event : std::uint8_t {
+        AccountOpened,
+        Deposit,
+        Withdrawal,
+        Check,
+        Interest,
+        Matured,
+        ServiceCharge,
+        TransferIn,  // From `counterparty`
+        TransferOut, // To `counterparty`, with the same outcomes as a withdrawal
+    };
+    enum class Outcome : std::uint8_t {
+        Success,
+        SuccessWithPenalty,  // Withdrawal of `amount` with a penalty of `amount * rate`
+        InsufficientFunds,   // Not enough to cover `amount`, or the service charge only partially covered
+        AtMinimumBalance,    // Balance was already at or below `minBalance`
+        BelowMinimumBalance, // Would have placed the balance below `minBalance`
+        CheckLimitReached,
+        NoFunds,
+        // As AtMinimumBalance and BelowMinimumBalance, for the checking accounts which describe these failures by the
+        // action taken, e.g. "check failure ($X)"
+        ActionAtMinimumBalance,
+        ActionBelowMinimumBalance,
+    };
+
+    Event event;
+    Outcome outcome = Outcome::Success;
+    int counterparty = 0;
+    Money amount = 0_dollars;
+    Money minBalance = 0_dollars;
+    Rate rate = 0.0;
     Money balanceChange;
     enum : char { Increase = '+', Decrease = '-', None = '=' } changeType;
     Money resultantBalance;
+
+    bool succeeded() const { return outcome == Outcome::Success || outcome == Outcome::SuccessWithPenalty; }
+};
+
+/**
+ * @brief Date-ordered sequence of statement records stored contiguously.
+ *
+ * Records almost always arrive in date order, so adding one is normally a push to the back. An out of order record is
+ * inserted after every record on or before its date, giving the same ordering as a std::multimap.
+ */
+class StatementRecords
+{
+public:
+    using value_type = std::pair<Date, StatementRecordInfo>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+    using iterator = const_iterator;
+
+    const_iterator emplace(Date when, StatementRecordInfo info) {
+        if (records_.empty() || records_.back().first <= when) {
+            records_.emplace_back(when, std::move(info));
+            return std::prev(records_.cend());
+        }
+
+        auto pos = std::upper_bound(records_.cbegin(), records_.cend(), when,
+                                    [](Date date, const value_type& record) { return date < record.first; });
+        return records_.emplace(pos, when, std::move(info));
+    }
+
+    //! All records dated `when`, in the order they were added
+    std::pair<const_iterator, const_iterator> equal_range(Date when) const {
+        struct Compare
+        {
+            bool operator()(const value_type& record, Date date) const { return record.first < date; }
+            bool operator()(Date date, const value_type& record) const { return date < record.first; }
+        };
+        return std::equal_range(records_.cbegin(), records_.cend(), when, Compare{});
+    }
+
+    //! The most recently added of the records dated `when`, of which there must be at least one
+    const StatementRecordInfo& lastOn(Date when) const { return records_[lastIndexOn(when)].second; }
+    //! Only the record itself may be changed, as its date determines where it is stored
+    StatementRecordInfo& lastOn(Date when) { return records_[lastIndexOn(when)].second; }
+
+    void reserve(std::size_t capacity) { records_.reserve(capacity); }
+    std::size_t capacity() const { return records_.capacity(); }
+    void clear() { records_.clear(); }
+
+    std::size_t size() const { return records_.size(); }
+    bool empty() const { return records_.empty(); }
+
+    const_iterator begin() const { return records_.cbegin(); }
+    const_iterator end() const { return records_.cend(); }
+
+private:
+    std::size_t lastIndexOn(Date when) const {
+        // Records on the same date keep their order, and `when` is nearly always the latest date
+        auto last = std::prev(records_.cend());
+        if (last->first != when) {
+            last = std::prev(equal_range(when).second);
+        }
+        return static_cast<std::size_t>(last - records_.cbegin());
+    }
+
+    std::vector<value_type> records_;
 };
 
 struct MonthlyStatement
 {
     Date start;
     Date end;
-    std::multimap<Date, StatementRecordInfo> records;
+    StatementRecords records;
     bool complete = false;
 };
 
+class StatementArchive;
+
+/**
+ * @brief One month of an account's history, either held in memory or moved out to a StatementArchive.
+ *
+ * Statements in memory are shared between copies of an account until one of them changes. An archived statement is
+ * read back whenever it is needed, and held in memory again once it is changed.
+ */
+class StoredStatement
+{
+public:
+    explicit StoredStatement(MonthlyStatement statement)
+        : month_{statement.start.monthIndex()}
+        , resident_{std::move(statement)} {}
+
+    //! The @ref Date::monthIndex of the statement, which is known without reading it back
+    std::int32_t month() const { return month_; }
+    bool archived() const { return archive_ != nullptr; }
+
+    //! The statement if it is in memory, otherwise null
+    const MonthlyStatement* resident() const { return resident_.get(); }
+    //! The statement, read back from the archive if need be, which stays as it is while held
+    std::shared_ptr<const MonthlyStatement> load() const;
+    //! Brings the statement back into memory if it was archived
+    MonthlyStatement& mutate();
+
+    //! Moves the statement to `archive`, stored under account `number`
+    void archiveTo(std::shared_ptr<StatementArchive> archive, int number);
+
+private:
+    std::int32_t month_;
+    util::CowPtr<MonthlyStatement> resident_;
+    // Where the statement is in the archive, which is kept open while it is in use
+    std::shared_ptr<StatementArchive> archive_;
+    std::uint64_t offset_ = 0;
+    std::uint64_t size_ = 0;
+};
+
+/**
+ * @brief Every month of an account's history, in order, where months without any records need not be stored.
+ *
+ * Months missing from storage are produced as empty statements while iterating, and archived months are read back.
+ */
+class MonthlyStatementRange
+{
+public:
+    class Iterator
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = MonthlyStatement;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() = default;
+
+        // Refers into the iterator itself for months which are not stored
+        const MonthlyStatement& operator*() const { return useStored_ ? *current_ : empty_; }
+        const MonthlyStatement* operator->() const { return &**this; }
+
+        Iterator& operator++() {
+            if (useStored_) {
+                ++stored_;
+            }
+            ++month_;
+            settle();
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        bool operator==(const Iterator& other) const { return month_ == other.month_; }
+
+    private:
+        friend class MonthlyStatementRange;
+
+        Iterator(const StoredStatement* stored, const StoredStatement* storedEnd, std::int32_t month,
+                 std::int32_t lastMonth)
+            : stored_{stored}
+            , storedEnd_{storedEnd}
+            , month_{month}
+            , lastMonth_{lastMonth} {
+            settle();
+        }
+
+        void settle() {
+            useStored_ = stored_ != storedEnd_ && stored_->month() == month_;
+            if (useStored_) {
+                current_ = stored_->resident();
+                if (current_ == nullptr) {
+                    loaded_ = stored_->load();
+                    current_ = loaded_.get();
+                }
+            } else if (month_ <= lastMonth_) {
+                empty_.start = Date::fromMonthIndex(month_);
+                empty_.end = empty_.start.monthEnd();
+                empty_.complete = month_ != lastMonth_;
+            }
+        }
+
+        const StoredStatement* stored_ = nullptr;
+        const StoredStatement* storedEnd_ = nullptr;
+        std::int32_t month_ = 0;
+        std::int32_t lastMonth_ = 0;
+        bool useStored_ = false;
+        const MonthlyStatement* current_ = nullptr;
+        // Holds the current statement if it was read back from an archive
+        std::shared_ptr<const MonthlyStatement> loaded_;
+        MonthlyStatement empty_;
+    };
+
+    /**
+     * @param stored Statements with at least one record, ordered by month
+     * @param firstMonth, lastMonth Inclusive range of @ref Date::monthIndex to cover
+     */
+    MonthlyStatementRange(std::span<const StoredStatement> stored, std::int32_t firstMonth, std::int32_t lastMonth)
+        : stored_{stored}
+        , firstMonth_{firstMonth}
+        , lastMonth_{std::max(lastMonth, firstMonth - 1)} {}
+
+    Iterator begin() const {
+        return Iterator{stored_.data(), stored_.data() + stored_.size(), firstMonth_, lastMonth_};
+    }
+    Iterator end() const {
+        return Iterator{stored_.data() + stored_.size(), stored_.data() + stored_.size(), lastMonth_ + 1, lastMonth_};
+    }
+
+    std::size_t size() const { return static_cast<std::size_t>(lastMonth_ - firstMonth_ + 1); }
+    bool empty() const { return size() == 0; }
+
+private:
+    std::span<const StoredStatement> stored_;
+    std::int32_t firstMonth_;
+    std::int32_t lastMonth_;
+};
+
 template <>
-struct fmt::formatter<StatementRecordInfo> : formatter<std::string>
+struct fmt::formatter<StatementRecordInfo> : formatter<std::string_view>
 {
     template <typename FormatCtx>
     FormatCtx::iterator format(const StatementRecordInfo& record, FormatCtx& ctx) const {
-        std::string balanceChange = fmt::format("{}{}", static_cast<char>(record.changeType), record.balanceChange);
-        std::string str =
-            fmt::format("{0:<80} [{1:>20}] ({2:>20})", record.details, balanceChange, record.resultantBalance);
-        return formatter<std::string>::format(str, ctx);
+        // A line fits within the inline storage of the buffer, so nothing is allocated for it
+        fmt::memory_buffer line;
+        formatLine(fmt::appender(line), record);
+        return formatter<std::string_view>::format(std::string_view{line.data(), line.size()}, ctx);
+    }
+
+    //! Writes the record as a line of a statement, with its columns padded, as formatting it does without a width
+    template <typename OutputIt>
+    static OutputIt formatLine(OutputIt out, const StatementRecordInfo& record) {
+        fmt::memory_buffer details;
+        formatDetails(fmt::appender(details), record);
+
+        fmt::basic_memory_buffer<char, 32> change;
+        change.push_back(static_cast<char>(record.changeType));
+        fmt::format_to(fmt::appender(change), "{}", record.balanceChange);
+
+        return fmt::format_to(out, "{0:<80} [{1:>20}] ({2:>20})", std::string_view{details.data(), details.size()},
+                              std::string_view{change.data(), change.size()}, record.resultantBalance);
+    }
+
+private:
+    template <typename OutputIt>
+    static OutputIt formatDetails(OutputIt out, const StatementRecordInfo& record) {
+        using Event = StatementRecordInfo::Event;
+        using Outcome = StatementRecordInfo::Outcome;
+
+        switch (record.event) {
+        case Event::AccountOpened:
+            return fmt::format_to(out, "Account opened");
+        case Event::Deposit:
+            return fmt::format_to(out, "Successful deposit");
+        case Event::Matured:
+            return fmt::format_to(out, "CD Account fully matured");
+        case Event::Interest:
+            if (record.outcome == Outcome::Success) {
+                return fmt::format_to(out, "Accumulated interest at {:.2f}%", static_cast<double>(record.rate) * 100);
+            }
+            return fmt::format_to(out, "Failed to earn interest as account balance is below minimum requirement");
+        case Event::ServiceCharge:
+            switch (record.outcome) {
+            case Outcome::InsufficientFunds:
+                return fmt::format_to(out, "Service charge fee. Account has run out of funds.");
+            case Outcome::NoFunds:
+                return fmt::format_to(out, "Attempted service charge fee, but account is empty.");
+            default:
+                return fmt::format_to(out, "Service charge fee");
+            }
+        case Event::TransferIn:
+            return fmt::format_to(out, "Transfer from account {}", record.counterparty);
+        case Event::Withdrawal:
+        case Event::Check:
+        case Event::TransferOut:
+            break;
+        }
+
+        const bool isCheck = record.event == Event::Check;
+        const bool isTransfer = record.event == Event::TransferOut;
+        switch (record.outcome) {
+        case Outcome::Success:
+            if (isTransfer) {
+                return fmt::format_to(out, "Transfer to account {}", record.counterparty);
+            }
+            return fmt::format_to(out, "Successful {}", isCheck ? "check" : "withdrawal");
+        case Outcome::SuccessWithPenalty:
+            if (isTransfer) {
+                return fmt::format_to(out, "Transfer of {} to account {} with penalty of {}", record.amount,
+                                      record.counterparty, record.amount * record.rate);
+            }
+            return fmt::format_to(out, "Successful withdrawal of {} with penalty of {}", record.amount,
+                                  record.amount * record.rate);
+        default:
+            break;
+        }
+
+        const bool byAction = record.outcome == Outcome::ActionAtMinimumBalance ||
+                              record.outcome == Outcome::ActionBelowMinimumBalance;
+        if (isTransfer) {
+            out = fmt::format_to(out, "Failed to transfer {} to account {}", record.amount, record.counterparty);
+        } else if (byAction) {
+            out = fmt::format_to(out, "{} failure ({})", isCheck ? "check" : "withdrawal", record.amount);
+        } else if (isCheck) {
+            out = fmt::format_to(out, "Failed to write check for {}", record.amount);
+        } else {
+            out = fmt::format_to(out, "Failed to withdraw {}", record.amount);
+        }
+
+        switch (record.outcome) {
+        case Outcome::AtMinimumBalance:
+        case Outcome::ActionAtMinimumBalance:
+            return fmt::format_to(out, ". Account balance already at or below minimum of {}.", record.minBalance);
+        case Outcome::BelowMinimumBalance:
+        case Outcome::ActionBelowMinimumBalance:
+            return fmt::format_to(out, ". Would place account below minimum of {}.", record.minBalance);
+        case Outcome::CheckLimitReached:
+            return fmt::format_to(out, ". Reached maximum allowable checks in one month.");
+        default:
+            return out;
+        }
     }
 };
 
@@ -43,11 +381,15 @@ struct fmt::formatter<MonthlyStatement> : formatter<std::string>
         auto iter = fmt::format_to(ctx.out(), "Monthly Statement for {0:%B} {0:%Y} ({0:%D} to {1:%D}){2}\n",
                                    statement.start, statement.end, statement.complete ? "" : " INCOMPLETE");
         for (const auto& [date, rec] : statement.records) {
-            iter = fmt::format_to(ctx.out(), "\t{0:%m}/{0:%d}: {1}\n", date, rec);
+            const auto ymd = date.get();
+            iter = fmt::format_to(iter, "\t{:02}/{:02}: ", static_cast<unsigned>(ymd.month()),
+                                  static_cast<unsigned>(ymd.day()));
+            iter = fmt::formatter<StatementRecordInfo>::formatLine(iter, rec);
+            *iter++ = '\n';
         }
 
         if (statement.records.empty()) {
-            iter = fmt::format_to(ctx.out(), "\tNo records\n");
+            iter = fmt::format_to(iter, "\tNo records\n");
         }
 
         return iter;
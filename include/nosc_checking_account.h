@@ -5,9 +5,13 @@
 #include "checking_account.h"
 #include "interest_handler.h"
 #include "money_type.h"
+#include "transaction.h"
 #include "util/date_util.h"
 
+#include <cstddef>
+#include <span>
 #include <string_view>
+#include <utility>
 
 class NoServiceChargeCheckingAccount : public AccountInfo
 {
@@ -15,18 +19,32 @@ public:
     NoServiceChargeCheckingAccount(std::string_view holderName, Money startingBalance,
                                    const InterestHandler& interestHandler, TimeManager auto timeManager = {});
     NoServiceChargeCheckingAccount(const NoServiceChargeCheckingAccount& other);
-    NoServiceChargeCheckingAccount(NoServiceChargeCheckingAccount&&) = default;
+    NoServiceChargeCheckingAccount(NoServiceChargeCheckingAccount&& other) noexcept;
     NoServiceChargeCheckingAccount& operator=(const NoServiceChargeCheckingAccount& rhs);
-    NoServiceChargeCheckingAccount& operator=(NoServiceChargeCheckingAccount&&) = default;
+    NoServiceChargeCheckingAccount& operator=(NoServiceChargeCheckingAccount&& rhs) noexcept;
     ~NoServiceChargeCheckingAccount() = default;
 
     void deposit(Money amount);
     void withdraw(Money amount);
     void writeCheck(Money amount);
+    std::size_t apply(std::span<const Transaction> batch);
+    bool transferOut(Money amount, int to);
+    void transferIn(Money amount, int from);
 
 private:
+    friend class AccountInfo;
+    friend class SnapshotCodec;
+
+    //! Restores an account read by SnapshotCodec, which then sets the rest of its state
+    NoServiceChargeCheckingAccount(AccountInfo&& info, const InterestHandler& interestHandler,
+                                   TimeManager auto timeManager);
+
+    void depositOn(Date when, Money amount);
+    void withdrawOn(Date when, Money amount);
+    void writeCheckOn(Date when, Money amount);
     void update(DatePeriod period);
-    void withdrawHelper(Money amount, std::string_view action);
+    Date getNextEventDate() const;
+    void withdrawHelper(Date when, Money amount, StatementRecordInfo::Event action);
 
     constexpr static Money MIN_BALANCE = 100_dollars;
 
@@ -40,11 +58,18 @@ NoServiceChargeCheckingAccount::NoServiceChargeCheckingAccount(std::string_view
     : AccountInfo(holderName, startingBalance, timeManager.getDate())
     , interestHandler_(interestHandler)
     , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {
-    addToMonthlyStatement(timeManager.getDate(), {.details = "Account opened",
+    addToMonthlyStatement(timeManager.getDate(), {.event = StatementRecordInfo::Event::AccountOpened,
                                                   .balanceChange = getBalance(),
                                                   .changeType = StatementRecordInfo::None,
                                                   .resultantBalance = getBalance()});
 }
 
+NoServiceChargeCheckingAccount::NoServiceChargeCheckingAccount(AccountInfo&& info,
+                                                               const InterestHandler& interestHandler,
+                                                               TimeManager auto timeManager)
+    : AccountInfo(std::move(info))
+    , interestHandler_(interestHandler)
+    , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {}
+
 static_assert(BankAccountConcept<NoServiceChargeCheckingAccount>);
 static_assert(CheckingAccountConcept<NoServiceChargeCheckingAccount>);
@@ -3,24 +3,41 @@
 #include "account_info.h"
 #include "bank_account.h"
 #include "interest_handler.h"
+#include "transaction.h"
 #include "util/date_util.h"
 
+#include <cstddef>
+#include <span>
+#include <utility>
+
 class SavingsAccount : public AccountInfo
 {
 public:
     SavingsAccount(std::string_view holderName, Money startingBalance, const InterestHandler& interestHandler,
                    TimeManager auto timeManager = {});
     SavingsAccount(const SavingsAccount& other);
-    SavingsAccount(SavingsAccount&&) = default;
+    SavingsAccount(SavingsAccount&& other) noexcept;
     SavingsAccount& operator=(const SavingsAccount& rhs);
-    SavingsAccount& operator=(SavingsAccount&&) = default;
+    SavingsAccount& operator=(SavingsAccount&& rhs) noexcept;
     ~SavingsAccount() = default;
 
     void deposit(Money amount);
     void withdraw(Money amount);
+    std::size_t apply(std::span<const Transaction> batch);
+    bool transferOut(Money amount, int to);
+    void transferIn(Money amount, int from);
 
 private:
+    friend class AccountInfo;
+    friend class SnapshotCodec;
+
+    //! Restores an account read by SnapshotCodec, which then sets the rest of its state
+    SavingsAccount(AccountInfo&& info, const InterestHandler& interestHandler, TimeManager auto timeManager);
+
+    void depositOn(Date when, Money amount);
+    void withdrawOn(Date when, Money amount);
     void update(DatePeriod period);
+    Date getNextEventDate() const;
 
     InterestHandler interestHandler_;
     TimeManagerResource timeManager_;
@@ -31,10 +48,15 @@ SavingsAccount::SavingsAccount(std::string_view holderName, Money startingBalanc
     : AccountInfo(holderName, startingBalance, timeManager.getDate())
     , interestHandler_(interestHandler)
     , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {
-    addToMonthlyStatement(timeManager.getDate(), {.details = "Account opened",
+    addToMonthlyStatement(timeManager.getDate(), {.event = StatementRecordInfo::Event::AccountOpened,
                                                   .balanceChange = getBalance(),
                                                   .changeType = StatementRecordInfo::None,
                                                   .resultantBalance = getBalance()});
 }
 
+SavingsAccount::SavingsAccount(AccountInfo&& info, const InterestHandler& interestHandler, TimeManager auto timeManager)
+    : AccountInfo(std::move(info))
+    , interestHandler_(interestHandler)
+    , timeManager_(timeManager, [this](DatePeriod period) { update(period); }) {}
+
 static_assert(BankAccountConcept<SavingsAccount>);
@@ -5,30 +5,47 @@
 #include "checking_account.h"
 #include "money_type.h"
 #include "monthly_statement.h"
+#include "transaction.h"
 #include "util/date_util.h"
 
+#include <cstddef>
+#include <span>
 #include <string_view>
+#include <utility>
 
 class ServiceChargeCheckingAccount : public AccountInfo
 {
 public:
     ServiceChargeCheckingAccount(std::string_view holderName, Money startingBalance, TimeManager auto timeManager = {});
     ServiceChargeCheckingAccount(const ServiceChargeCheckingAccount& other);
-    ServiceChargeCheckingAccount(ServiceChargeCheckingAccount&&) = default;
+    ServiceChargeCheckingAccount(ServiceChargeCheckingAccount&& other) noexcept;
     ServiceChargeCheckingAccount& operator=(const ServiceChargeCheckingAccount& rhs);
-    ServiceChargeCheckingAccount& operator=(ServiceChargeCheckingAccount&&) = default;
+    ServiceChargeCheckingAccount& operator=(ServiceChargeCheckingAccount&& rhs) noexcept;
     ~ServiceChargeCheckingAccount() = default;
 
     void deposit(Money amt);
     void withdraw(Money amt);
 
     void writeCheck(Money amount);
+    std::size_t apply(std::span<const Transaction> batch);
+    bool transferOut(Money amount, int to);
+    void transferIn(Money amount, int from);
 
     constexpr static Money SERVICE_CHARGE = 100_dollars;
     constexpr static int CHECKS_PER_MONTH = 10;
 
 private:
+    friend class AccountInfo;
+    friend class SnapshotCodec;
+
+    //! Restores an account read by SnapshotCodec, which then sets the rest of its state
+    ServiceChargeCheckingAccount(AccountInfo&& info, TimeManager auto timeManager);
+
+    void depositOn(Date when, Money amt);
+    void withdrawOn(Date when, Money amt);
+    void writeCheckOn(Date when, Money amount);
     void update(DatePeriod period);
+    Date getNextEventDate() const;
     void withdrawHelper(Money amount, std::string_view action);
 
     int remainingChecks_ = CHECKS_PER_MONTH;
@@ -41,11 +58,16 @@ ServiceChargeCheckingAccount::ServiceChargeCheckingAccount(std::string_view hold
     : AccountInfo(holderName, startingBalance, timeManager.getDate())
     , timeManager_(timeManager, [this](DatePeriod period) { update(period); })
     , lastServiceCharge_(timeManager_.getDate()) {
-    addToMonthlyStatement(timeManager.getDate(), {.details = "Account opened",
+    addToMonthlyStatement(timeManager.getDate(), {.event = StatementRecordInfo::Event::AccountOpened,
                                                   .balanceChange = getBalance(),
                                                   .changeType = StatementRecordInfo::None,
                                                   .resultantBalance = getBalance()});
 }
 
+ServiceChargeCheckingAccount::ServiceChargeCheckingAccount(AccountInfo&& info, TimeManager auto timeManager)
+    : AccountInfo(std::move(info))
+    , timeManager_(timeManager, [this](DatePeriod period) { update(period); })
+    , lastServiceCharge_(timeManager_.getDate()) {}
+
 static_assert(BankAccountConcept<ServiceChargeCheckingAccount>);
 static_assert(CheckingAccountConcept<ServiceChargeCheckingAccount>);
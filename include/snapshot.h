@@ -0,0 +1,144 @@
+/*! \file snapshot.h
+    \brief File containing the Snapshot and SnapshotWriter classes
+
+    Saving every open account, with its full history, to a binary file and loading it back
+*/
+#pragma once
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "money_type.h"
+#include "monthly_statement.h"
+#include "util/date_util.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+//! The concrete type of an account stored in a snapshot
+enum class AccountKind : std::uint8_t {
+    CertificateOfDeposit,
+    Savings,
+    HighInterestSavings,
+    ServiceChargeChecking,
+    NoServiceChargeChecking,
+    HighInterestChecking,
+};
+
+//! Collects accounts and writes them to a snapshot file
+/*!
+  Each account is encoded when it is added, so the writer does not need to keep the account alive, and the accounts may
+  keep changing afterwards.
+*/
+class SnapshotWriter
+{
+public:
+    //! Throws std::invalid_argument if the account is not one of the standard types
+    void add(const BankAccount& account);
+
+    //! Writes the accounts added so far, together with the simulated date
+    /*!
+      The file is written under a temporary name, synced to disk and then renamed, and the directory is synced after the
+      rename. An existing snapshot at `path` is only replaced once the new one is complete, and once this returns the
+      new one survives a crash. Throws std::runtime_error if the file cannot be written.
+    */
+    void write(const std::filesystem::path& path) const;
+
+    //! Records that the snapshot includes every journal record up to `sequence`, see Journal::replay
+    void setJournalSequence(std::uint64_t sequence) { journalSequence_ = sequence; }
+
+    std::size_t size() const { return index_.size(); }
+
+private:
+    friend class SnapshotCodec;
+
+    struct IndexEntry
+    {
+        int number;
+        AccountKind kind;
+        Date openingDate;
+        Money balance;
+        std::uint32_t nameLength;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    std::vector<IndexEntry> index_;
+    std::vector<std::byte> data_;
+    std::uint64_t journalSequence_ = 0;
+};
+
+//! Writes every account in `accounts` to `path`, see SnapshotWriter::write
+void writeSnapshot(const std::filesystem::path& path, const AccountStore<BankAccount>& accounts,
+                   std::uint64_t journalSequence = 0);
+
+//! Encodes one account the same way as in a snapshot, for storing outside of one
+std::vector<std::byte> encodeAccount(const BankAccount& account);
+//! Restores an account from @ref encodeAccount, as Snapshot::load does. Throws std::runtime_error if `data` is corrupt
+BankAccount decodeAccount(std::span<const std::byte> data);
+
+//! Appends the encoding of one monthly statement to `out`, the same as within an account in a snapshot
+void encodeStatement(const MonthlyStatement& statement, std::vector<std::byte>& out);
+//! Throws std::runtime_error if `data` does not start with a statement from @ref encodeStatement
+MonthlyStatement decodeStatement(std::span<const std::byte> data);
+
+//! A snapshot file, mapped into memory
+/*!
+  Opening a snapshot only checks its header. The index of accounts is read in place, so @ref summary and @ref find work
+  straight away without loading anything. Accounts are only decoded when loaded.
+
+  A loaded account registers with SimTimeManager, whose date should be set from the snapshot by @ref restoreTime
+  first. Loaded accounts keep their account numbers, and numbers for new accounts continue after them.
+
+  The format stores numbers in little-endian order, which is also required of the host.
+*/
+class Snapshot
+{
+public:
+    //! What can be read about an account without loading it
+    struct AccountSummary
+    {
+        int number;
+        AccountKind kind;
+        std::string_view holderName; // Refers into the mapped file
+        Money balance;
+        Date openingDate;
+    };
+
+    //! Throws std::runtime_error if the file cannot be mapped or is not a snapshot of a supported version
+    explicit Snapshot(const std::filesystem::path& path);
+    Snapshot(const Snapshot&) = delete;
+    Snapshot(Snapshot&& other) noexcept;
+    Snapshot& operator=(const Snapshot&) = delete;
+    Snapshot& operator=(Snapshot&& rhs) noexcept;
+    ~Snapshot();
+
+    //! The simulated date when the snapshot was written
+    Date getDate() const;
+    //! Sets SimTimeManager to the date of the snapshot
+    void restoreTime() const;
+    //! The last journal record included in the snapshot, or 0 if it was not written alongside a journal
+    std::uint64_t journalSequence() const;
+
+    //! Accounts are ordered by account number
+    std::size_t size() const;
+    bool empty() const { return size() == 0; }
+    AccountSummary summary(std::size_t index) const;
+    std::optional<AccountSummary> find(int number) const;
+
+    BankAccount load(std::size_t index) const;
+    //! Restores the simulated date, then loads every account into `accounts`
+    void loadInto(AccountStore<BankAccount>& accounts) const;
+
+private:
+    friend class SnapshotCodec;
+
+    void unmap() noexcept;
+
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+};
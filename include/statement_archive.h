@@ -0,0 +1,86 @@
+/*! \file statement_archive.h
+    \brief File containing the StatementArchive class
+
+    Moving completed monthly statements out of memory, so long account histories take bounded memory
+*/
+#pragma once
+
+#include "monthly_statement.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+//! Append-only file which completed monthly statements of every account are moved to
+/*!
+  While an archive is active, each account moves its completed months to it as months end, once they are older than
+  @ref Options::maxResidentMonths or the account has more than @ref Options::maxResidentRecords records in completed
+  months. Only the latest months are then held in memory, however long an account has been open.
+
+  Archived statements are read back transparently by AccountInfo::getMonthlyStatement and
+  AccountInfo::getAllMonthlyStatements, through a small cache of the most recently read ones. Each archived statement
+  keeps its archive open, so it stays readable after another archive is made active.
+
+  The file only lasts as long as the archive, as snapshots save the full history themselves. All members are safe to
+  use from any thread.
+*/
+class StatementArchive
+{
+public:
+    struct Options
+    {
+        //! Completed months are archived once they are this many months before the account's current month
+        std::int32_t maxResidentMonths = 12;
+        //! Most records an account keeps in memory for completed months, beyond which the oldest months are archived
+        std::size_t maxResidentRecords = 2048;
+        //! How many statements read back from the archive are kept in memory, across all accounts
+        std::size_t cacheSize = 64;
+    };
+
+    //! Creates the archive file at `path`, replacing any file there. Throws std::runtime_error if it cannot be created.
+    explicit StatementArchive(const std::filesystem::path& path);
+    StatementArchive(const std::filesystem::path& path, Options options);
+    StatementArchive(const StatementArchive&) = delete;
+    StatementArchive(StatementArchive&&) = delete;
+    StatementArchive& operator=(const StatementArchive&) = delete;
+    StatementArchive& operator=(StatementArchive&&) = delete;
+    //! Removes the file
+    ~StatementArchive();
+
+    //! Archives completed statements of every account to `archive` from now on, or stops archiving if it is null
+    static void setActive(std::shared_ptr<StatementArchive> archive);
+    static std::shared_ptr<StatementArchive> active();
+
+    const Options& options() const { return options_; }
+    //! How many statements have been archived
+    std::size_t size() const;
+    //! How many statements are read back from the file rather than from the cache
+    std::size_t numReads() const;
+
+private:
+    friend class StoredStatement;
+
+    //! Appends `statement` of account `number`, returning its offset and size in the file
+    std::pair<std::uint64_t, std::uint64_t> add(int number, const MonthlyStatement& statement);
+    //! Throws std::runtime_error if the file cannot be read, or does not hold a statement for `month` there
+    std::shared_ptr<const MonthlyStatement> load(std::uint64_t offset, std::uint64_t size, std::int32_t month);
+
+    using CacheList = std::list<std::pair<std::uint64_t, std::shared_ptr<const MonthlyStatement>>>;
+
+    std::filesystem::path path_;
+    Options options_;
+    int fd_ = -1;
+
+    mutable std::mutex mutex_;
+    std::uint64_t fileSize_ = 0;
+    std::size_t numStatements_ = 0;
+    std::size_t numReads_ = 0;
+    // Most recently used first, looked up by offset
+    CacheList cache_;
+    std::unordered_map<std::uint64_t, CacheList::iterator> cacheIndex_;
+};
@@ -0,0 +1,82 @@
+/*! \file statement_renderer.h
+    \brief File containing the StatementRenderer and StatementExporter classes
+
+    Rendering monthly statements as text in bulk, for showing them or writing them to a file
+*/
+#pragma once
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "monthly_statement.h"
+
+#include <fmt/format.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+#include <utility>
+
+//! Renders monthly statements into a buffer which is kept between uses
+/*!
+  Statements are written as they are formatted with fmt, straight into the buffer, so once it has grown large enough
+  rendering does not allocate for each statement or record.
+*/
+class StatementRenderer
+{
+public:
+    //! Appends `statement`
+    void render(const MonthlyStatement& statement);
+    //! Appends every statement of `account`, separated by blank lines
+    void renderAll(const BankAccount& account);
+    //! Appends text formatted as by fmt::format, such as headings between statements
+    template <typename... Args>
+    void append(fmt::format_string<Args...> format, Args&&... args) {
+        fmt::format_to(fmt::appender(buffer_), format, std::forward<Args>(args)...);
+    }
+
+    std::string_view view() const { return {buffer_.data(), buffer_.size()}; }
+    std::size_t size() const { return buffer_.size(); }
+    //! Empties the buffer, keeping its memory for what is rendered next
+    void clear() { buffer_.clear(); }
+
+private:
+    fmt::memory_buffer buffer_;
+};
+
+//! Writes the statements of many accounts to a text file
+/*!
+  Accounts are rendered into a buffer of about `bufferSize` bytes, which is written to the file whenever it fills, so
+  the file receives few large writes however many accounts there are.
+*/
+class StatementExporter
+{
+public:
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE = std::size_t{1} << 20;
+
+    //! Creates the file at `path`, replacing any file there. Throws std::runtime_error if it cannot be created.
+    explicit StatementExporter(const std::filesystem::path& path, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    StatementExporter(const StatementExporter&) = delete;
+    StatementExporter(StatementExporter&&) = delete;
+    StatementExporter& operator=(const StatementExporter&) = delete;
+    StatementExporter& operator=(StatementExporter&&) = delete;
+    //! Writes out whatever is still buffered, ignoring failures. Call @ref flush to find out about them.
+    ~StatementExporter();
+
+    //! Appends a heading for `account`, followed by all its statements
+    void add(const BankAccount& account);
+    //! Writes out everything added so far. Throws std::runtime_error if the file cannot be written.
+    void flush();
+
+    //! How many accounts have been added
+    std::size_t size() const { return numAccounts_; }
+
+private:
+    std::ofstream file_;
+    std::size_t bufferSize_;
+    std::size_t numAccounts_ = 0;
+    StatementRenderer renderer_;
+};
+
+//! Writes the statements of every account in `accounts` to `path`, see StatementExporter
+void exportStatements(const std::filesystem::path& path, const AccountStore<BankAccount>& accounts);
@@ -0,0 +1,27 @@
+/*! \file transaction.h
+    \brief File containing the Transaction struct
+
+    A single deposit, withdrawal or check, for applying to an account in a batch, and a transfer between accounts
+*/
+#pragma once
+
+#include "money_type.h"
+
+#include <cstdint>
+
+//! One account operation, equivalent to calling deposit, withdraw or writeCheck with `amount`
+struct Transaction
+{
+    enum class Type : std::uint8_t { Deposit, Withdrawal, Check };
+
+    Type type;
+    Money amount;
+};
+
+//! Moves `amount` from account `from` to account `to`, see TransactionEngine::transfer
+struct Transfer
+{
+    int from;
+    int to;
+    Money amount;
+};
@@ -0,0 +1,128 @@
+/*! \file transaction_engine.h
+    \brief File containing the TransactionEngine class
+
+    Open accounts which may be used from many threads at once
+*/
+#pragma once
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "money_type.h"
+#include "transaction.h"
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+//! Applies transactions to open accounts from any number of threads
+/*!
+  Accounts are split into shards by account number, each guarded by its own lock, so operations on accounts in
+  different shards run in parallel while those on the same account are serialized.
+
+  Time updates run account callbacks without taking any of these locks, so they must not overlap with other use of the
+  engine. Advance time inside @ref exclusively to pause everything else in the meantime. Creating an account also
+  registers it with its time manager, so open accounts through a factory if time may be advancing meanwhile.
+*/
+class TransactionEngine
+{
+public:
+    //! A `numShards` of 0 picks a number suited to the hardware concurrency
+    explicit TransactionEngine(std::size_t numShards = 0);
+
+    //! Returns the number of the newly opened account
+    int open(BankAccount account);
+    //! Opens the account returned by `makeAccount`, which is never called while @ref exclusively is running
+    template <std::invocable Factory>
+    int open(Factory&& makeAccount) {
+        // Held until the account is in its shard, as updates may run its callback from then on
+        const std::lock_guard lock{exclusiveMutex_};
+        return insert(std::forward<Factory>(makeAccount)());
+    }
+    //! Closes the account, returning whether one with this number was open
+    bool close(int number);
+
+    // Each returns whether the transaction succeeded, and throws std::out_of_range if the account is not open. Checks
+    // throw std::invalid_argument for accounts which cannot write them.
+    bool deposit(int number, Money amount);
+    bool withdraw(int number, Money amount);
+    bool writeCheck(int number, Money amount);
+    //! Returns how many of the transactions succeeded, see BankAccount::apply
+    std::size_t apply(int number, std::span<const Transaction> batch);
+
+    //! Withdraws `amount` from account `from` and deposits it into account `to`, with both locked throughout
+    /*!
+      The withdrawal follows the same rules as BankAccount::withdraw, so it may fail or incur a penalty, and nothing
+      is deposited if it fails. Both accounts record the transfer, each naming the other. Returns whether it succeeded.
+
+      Throws std::out_of_range if either account is not open, and std::invalid_argument if they are the same account or
+      `to` does not accept deposits.
+    */
+    bool transfer(int from, int to, Money amount);
+    //! Applies the transfers in order, returning how many succeeded
+    /*!
+      Every account involved is locked for the whole batch, so no other operation sees it partly applied. Each account
+      is checked before anything is applied, so an exception leaves every account untouched.
+    */
+    std::size_t transferBatch(std::span<const Transfer> batch);
+
+    Money getBalance(int number) const;
+
+    //! Calls `func` with the account while holding its lock, returning the result
+    template <typename Func>
+    decltype(auto) withAccount(int number, Func&& func) {
+        auto& shard = shardOf(number);
+        const std::lock_guard lock{shard.mutex};
+        return std::forward<Func>(func)(get(shard, number));
+    }
+    template <typename Func>
+    decltype(auto) withAccount(int number, Func&& func) const {
+        const auto& shard = shardOf(number);
+        const std::lock_guard lock{shard.mutex};
+        return std::forward<Func>(func)(get(shard, number));
+    }
+
+    //! Calls `func` while holding every lock, for anything which may not overlap with transactions
+    template <typename Func>
+    decltype(auto) exclusively(Func&& func) {
+        const std::lock_guard exclusiveLock{exclusiveMutex_};
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(numShards_);
+        for (std::size_t i = 0; i < numShards_; ++i) {
+            locks.emplace_back(shards_[i].mutex);
+        }
+        return std::forward<Func>(func)();
+    }
+
+    std::size_t size() const;
+    std::size_t numShards() const { return numShards_; }
+
+private:
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;
+        AccountStore<BankAccount> accounts;
+    };
+
+    // Whenever several shards are locked at once, they are locked in order of this index, so that no two threads can
+    // each be waiting on a lock the other holds
+    std::size_t shardIndex(int number) const { return static_cast<std::size_t>(number) % numShards_; }
+    Shard& shardOf(int number) { return shards_[shardIndex(number)]; }
+    const Shard& shardOf(int number) const { return shards_[shardIndex(number)]; }
+
+    int insert(BankAccount account);
+
+    //! Throws if account `from`, which must be open, may not transfer to `to`
+    static void checkTransfer(int from, const BankAccount& to);
+    static bool moveFunds(BankAccount& from, BankAccount& to, Money amount);
+
+    static BankAccount& get(Shard& shard, int number);
+    static const BankAccount& get(const Shard& shard, int number);
+
+    std::size_t numShards_;
+    std::unique_ptr<Shard[]> shards_; // NOLINT(*c-arrays)
+    std::mutex exclusiveMutex_;
+};
@@ -0,0 +1,71 @@
+/*! \file transaction_import.h
+    \brief File containing importTransactions
+
+    Loading transactions from CSV files into open accounts, moving the simulated date along with them
+*/
+#pragma once
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "transaction_engine.h"
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+struct ImportOptions
+{
+    //! Threads to parse and apply transactions on, including the caller. 0 picks the hardware concurrency.
+    std::size_t numThreads = 0;
+    //! Bytes of the file parsed as one piece of work
+    std::size_t chunkSize = std::size_t{1} << 20;
+    //! Most rejected rows described in the report. Any beyond that are only counted.
+    std::size_t maxRejections = 100;
+};
+
+struct ImportReport
+{
+    struct Rejection
+    {
+        std::size_t line;
+        std::string reason;
+    };
+
+    //! Rows read, not counting a header or blank lines
+    std::size_t numRows = 0;
+    //! Rows applied to their account, whether or not the transaction succeeded
+    std::size_t numApplied = 0;
+    //! Rows applied whose transaction succeeded
+    std::size_t numSucceeded = 0;
+    std::size_t numRejected = 0;
+    //! Up to ImportOptions::maxRejections of the rejected rows, ordered by line
+    std::vector<Rejection> rejections;
+    std::chrono::duration<double> elapsed{};
+
+    double rowsPerSecond() const {
+        return elapsed.count() > 0 ? static_cast<double>(numRows) / elapsed.count() : 0;
+    }
+};
+
+//! Applies each transaction in the CSV file at `path` to its account, on its date
+/*!
+  Each row is `account,date,type,amount`, such as `1042,2024-03-15,deposit,"$1,234.56"`, where the type is one of
+  `deposit`, `withdrawal` or `check` and the date is `YYYY-MM-DD`. A first line which does not start with a digit is
+  taken as a header. The amount is read by parseMoney, and must be quoted if it contains commas.
+
+  The file is mapped into memory and parsed in chunks on several threads. Rows are then applied in order of date,
+  moving SimTimeManager forward to each date first, and in file order within a date. Each date's rows are grouped by
+  account, and the accounts are applied in parallel, one batch each.
+
+  Malformed rows, rows dated before the simulated date, and rows for accounts which are not open or cannot take the
+  transaction are rejected and reported without stopping the import. Checks for accounts which cannot write them are
+  rejected on their own, and the other rows of that account's batch are still applied. Throws std::runtime_error if
+  the file cannot be read.
+*/
+ImportReport importTransactions(const std::filesystem::path& path, TransactionEngine& engine,
+                                const ImportOptions& options = {});
+//! As for a TransactionEngine, where `accounts` must not be used by anything else during the import
+ImportReport importTransactions(const std::filesystem::path& path, AccountStore<BankAccount>& accounts,
+                                const ImportOptions& options = {});
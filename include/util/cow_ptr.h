@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace util {
+
+/**
+ * @brief Owning pointer whose copies share the pointee until one of them modifies it.
+ *
+ * Copying is a reference count increment. @ref mutate gives write access, first copying the pointee if any other
+ * CowPtr still refers to it, so a modification is never seen through another copy.
+ *
+ * Separate CowPtrs may be used from separate threads, even while they share a pointee.
+ */
+template <typename T>
+class CowPtr
+{
+public:
+    //! Empty until first mutated
+    CowPtr() = default;
+    explicit CowPtr(T value)
+        : ptr_{std::make_shared<T>(std::move(value))} {}
+
+    //! Null when empty
+    const T* get() const { return ptr_.get(); }
+    const T& operator*() const { return *ptr_; }
+    const T* operator->() const { return ptr_.get(); }
+    explicit operator bool() const { return ptr_ != nullptr; }
+
+    //! Read-only reference to the pointee, which keeps it from changing while held, as mutating then copies it
+    std::shared_ptr<const T> share() const { return ptr_; }
+
+    //! Whether the pointee is shared with another CowPtr, so that the next @ref mutate will copy it
+    bool shared() const { return ptr_ != nullptr && ptr_.use_count() > 1; }
+
+    T& mutate() {
+        if (ptr_ == nullptr) {
+            ptr_ = std::make_shared<T>();
+        } else if (ptr_.use_count() > 1) {
+            // Another owner may release its copy meanwhile, in which case this copy was unnecessary but still correct
+            ptr_ = std::make_shared<T>(std::as_const(*ptr_));
+        } else {
+            // use_count is a relaxed load, so order this write after reads made through copies released elsewhere
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *ptr_;
+    }
+
+private:
+    std::shared_ptr<T> ptr_;
+};
+
+} // namespace util
@@ -1,81 +1,112 @@
 #pragma once
 
+#include "thread_pool.h"
 #include "util.h"
 
 #include <fmt/chrono.h>
 #include <fmt/core.h>
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <limits>
-#include <map>
+#include <memory>
+#include <mutex>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 inline std::chrono::year_month_day today() {
     const auto now = std::chrono::system_clock::now();
 
     return std::chrono::floor<std::chrono::days>(now);
 }
-inline std::chrono::year_month_day getMonthStart(std::chrono::year_month_day date) {
-    auto prevMonth = date - std::chrono::months{1};
-    auto prevMonthLastDay = std::chrono::year_month_day_last{prevMonth.year(), prevMonth.month() / std::chrono::last};
-    return std::chrono::sys_days{prevMonthLastDay} + std::chrono::days{1};
-}
-inline std::chrono::year_month_day getMonthEnd(std::chrono::year_month_day date) {
-    auto monthEnd = std::chrono::year_month_day_last{date.year(), date.month() / std::chrono::last};
-    return monthEnd;
-}
 
 /**
  * @brief Basic gregorian date to simplify working with std::chrono.
  *
+ * Stored as a count of days since the epoch, so comparisons and differences in days are single integer operations.
+ * Calendar fields are derived on demand in constant time.
  */
 class Date final
 {
 public:
     /**
-     * @brief Construct a new Date object with the current date.
+     * @brief Construct an invalid Date object, which compares before every valid date.
      *
      */
-    Date()
-        : date_{} {}
+    constexpr Date() = default;
 
-    explicit Date(std::chrono::year_month_day date)
-        : date_{std::chrono::sys_days{date}} {}
-    // explicit Date(int day, int month, int year)
-    //     : Date(std::chrono::year_month_day{std::chrono::year{year},
-    //                                        std::chrono::month{static_cast<unsigned int>(month)},
-    //                                        std::chrono::day{static_cast<unsigned int>(day)}}) {}
+    explicit constexpr Date(std::chrono::year_month_day date)
+        : Date{std::chrono::sys_days{date}} {}
+    explicit constexpr Date(std::chrono::sys_days date)
+        : days_{static_cast<std::int32_t>(date.time_since_epoch().count())} {}
 
-    std::chrono::year_month_day get() const { return date_; }
+    constexpr bool ok() const { return days_ != INVALID_DAYS; }
+
+    constexpr std::chrono::year_month_day get() const {
+        return ok() ? std::chrono::year_month_day{toSysDays()} : std::chrono::year_month_day{};
+    }
+    constexpr std::chrono::sys_days toSysDays() const { return std::chrono::sys_days{std::chrono::days{days_}}; }
 
     template <typename Ret = std::chrono::year_month_day>
-    Ret to() const {
-        return std::chrono::floor<Ret>(date_);
+    constexpr Ret to() const {
+        return std::chrono::floor<Ret>(toSysDays());
     }
 
+    //! Number of calendar months since January of year 0
+    constexpr std::int32_t monthIndex() const {
+        const auto date = get();
+        const auto month = static_cast<std::int32_t>(static_cast<unsigned>(date.month()));
+        return static_cast<std::int32_t>(date.year()) * 12 + month - 1;
+    }
+    //! First day of the month with the given @ref monthIndex
+    static constexpr Date fromMonthIndex(std::int32_t monthIndex) {
+        const std::int32_t year = (monthIndex >= 0 ? monthIndex : monthIndex - 11) / 12;
+        const auto month = static_cast<unsigned>(monthIndex - year * 12 + 1);
+        return Date{std::chrono::year{year} / std::chrono::month{month} / 1};
+    }
+    constexpr Date monthStart() const {
+        const auto date = get();
+        return Date{date.year() / date.month() / 1};
+    }
+    constexpr Date monthEnd() const {
+        const auto date = get();
+        return Date{std::chrono::year_month_day{date.year() / date.month() / std::chrono::last}};
+    }
+
+    constexpr Date operator+(std::chrono::days amount) const { return Date{toSysDays() + amount}; }
+    constexpr Date operator-(std::chrono::days amount) const { return Date{toSysDays() - amount}; }
+    // Calendar months, where days past the end of the resulting month overflow into the next
+    constexpr Date operator+(std::chrono::months amount) const { return Date{get() + amount}; }
+
     template <typename DurationType = std::chrono::days>
         requires std::convertible_to<DurationType, std::chrono::seconds>
     static constexpr std::int64_t diff(const Date& first, const Date& last) {
-        const auto sysFirst = std::chrono::sys_days{first.date_};
-        const auto sysLast = std::chrono::sys_days{last.date_};
-
-        const auto sysDiff = sysLast - sysFirst;
-        return std::chrono::floor<DurationType>(sysDiff).count();
+        return std::chrono::floor<DurationType>(std::chrono::days{last.days_ - first.days_}).count();
+    }
+    //! Difference between calendar months, regardless of the day within each month
+    static constexpr std::int64_t monthsBetween(const Date& first, const Date& last) {
+        return last.monthIndex() - first.monthIndex();
     }
 
     bool operator==(const Date& other) const = default;
     std::strong_ordering operator<=>(const Date& other) const = default;
 
-    friend struct fmt::formatter<Date>;
-
 private:
-    std::chrono::year_month_day date_;
+    static constexpr std::int32_t INVALID_DAYS = std::numeric_limits<std::int32_t>::min();
+
+    std::int32_t days_ = INVALID_DAYS;
 };
 
+static_assert(sizeof(Date) == sizeof(std::int32_t));
+
 // Inclusive period between two dates
 struct DatePeriod
 {
@@ -87,52 +118,277 @@ template <>
 struct fmt::formatter<Date> : formatter<std::chrono::sys_days>
 {
     format_context::iterator format(Date date, format_context& ctx) const {
-        return fmt::formatter<std::chrono::sys_days>::format(std::chrono::sys_days{date.date_}, ctx);
+        return fmt::formatter<std::chrono::sys_days>::format(date.toSysDays(), ctx);
     }
 };
 
 namespace detail {
 
+/**
+ * @brief Registry of time update callbacks, ordered by when each one next has something to do.
+ *
+ * A callback is only run by @ref updateDue once the date it was scheduled for has been reached. Callbacks start out
+ * due immediately and stay that way until they are given a date through @ref scheduleFn, so owners which never
+ * reschedule are still run on every update.
+ *
+ * Stored as a generational slot map: ids name a slot plus the generation it was handed out in, while the callbacks
+ * themselves are kept densely packed. Freed slots are reused, and bumping their generation invalidates stale ids.
+ *
+ * With @ref setUpdateThreads, due callbacks are split across a thread pool. Each callback must then only touch state
+ * belonging to its owner, and may not register, deregister or rebind while running.
+ *
+ * Registering, deregistering, rebinding and scheduling may be done from several threads at once. Updates must not
+ * overlap with any of those from other threads, though callbacks may still use them on the updating thread.
+ */
 template <typename>
 class Registry
 {
 public:
     using CallbackType = std::function<void(DatePeriod)>;
 
+    //! Bits of an id naming its slot, with the rest of a non-negative int holding the slot's generation
+    static constexpr int INDEX_BITS = 26;
+    //! How many callbacks may be registered at once, which is one per open account
+    static constexpr std::size_t MAX_REGISTRATIONS = std::size_t{1} << INDEX_BITS;
+
     static int registerFn(const CallbackType& func) {
-        int id = makeUniqueId();
-        [[maybe_unused]] auto result = callbacks_.insert({id, func});
-        util::ctassert(result.second, "Attempting to register with multiple of the same id");
+        util::ctassert(!runningParallel_, "Attempting to register during a parallel update");
+        const std::lock_guard lock{mutex_};
+
+        std::uint32_t index{};
+        if (freeSlots_.empty()) {
+            util::ctassert(slots_.size() <= MAX_INDEX, "Id's are out of range of int");
+            index = static_cast<std::uint32_t>(slots_.size());
+            slots_.push_back(Slot{});
+        } else {
+            index = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+
+        auto& slot = slots_[index];
+        slot.dense = static_cast<std::uint32_t>(callbacks_.size());
+        callbacks_.push_back(func);
+        nextDue_.emplace_back();
+        owners_.push_back(index);
+
+        const int id = makeId(index, slot.generation);
+        pushSchedule(Date{}, id);
         return id;
     }
 
     static void deregisterFn(int id) {
-        auto result = callbacks_.erase(id);
-        util::ctassert(result != 0, "Failed to erase registered function");
+        util::ctassert(!runningParallel_, "Attempting to deregister during a parallel update");
+        const std::lock_guard lock{mutex_};
+
+        auto* slot = findSlot(id);
+        util::ctassert(slot != nullptr, "Failed to erase registered function");
+
+        // Swap the last callback into the hole to keep storage dense. Its entries in the schedule refer to it by id, so
+        // they are unaffected.
+        const std::uint32_t dense = slot->dense;
+        const std::size_t last = callbacks_.size() - 1;
+        if (dense != last) {
+            callbacks_[dense] = std::move(callbacks_[last]);
+            nextDue_[dense] = nextDue_[last];
+            owners_[dense] = owners_[last];
+            slots_[owners_[dense]].dense = dense;
+        }
+        callbacks_.pop_back();
+        nextDue_.pop_back();
+        owners_.pop_back();
+
+        slot->dense = FREE;
+        slot->generation = (slot->generation + 1) & GENERATION_MASK;
+        freeSlots_.push_back(indexOf(id));
+    }
+
+    //! Replaces the callback of an existing registration, keeping its schedule
+    static void rebindFn(int id, const CallbackType& func) {
+        util::ctassert(!runningParallel_, "Attempting to rebind during a parallel update");
+        const std::lock_guard lock{mutex_};
+
+        auto* slot = findSlot(id);
+        util::ctassert(slot != nullptr, "Attempting to rebind an unregistered function");
+
+        callbacks_[slot->dense] = func;
+    }
+
+    //! Sets the date on which the callback next needs to be run
+    static void scheduleFn(int id, Date nextDue) {
+        // Each callback only reschedules itself, so the date alone is safe to set from any thread without the lock. The
+        // schedule is brought up to date once the parallel update finishes.
+        if (runningParallel_) {
+            setNextDue(id, nextDue);
+            return;
+        }
+
+        const std::lock_guard lock{mutex_};
+        if (setNextDue(id, nextDue)) {
+            pushSchedule(nextDue, id);
+        }
+    }
+
+    /**
+     * @brief Sets how many threads @ref updateDue runs callbacks on, including the calling thread.
+     *
+     * Callbacks run in sequence on the calling thread when set to 1 (the default). Results are the same either way, as
+     * callbacks are independent of each other.
+     */
+    static void setUpdateThreads(std::size_t numThreads) {
+        util::ctassert(!runningParallel_, "Attempting to resize the thread pool during a parallel update");
+
+        pool_ = numThreads > 1 ? std::make_unique<util::ThreadPool>(numThreads) : nullptr;
     }
 
-    static void updateAll(const std::function<void(int, const CallbackType&)>& func) {
-        for (const auto& [id, callback] : callbacks_) {
-            func(id, callback);
+protected:
+    //! Runs every callback which is due on or before the end of `period`
+    static void updateDue(DatePeriod period) {
+        // Callbacks reschedule themselves while running, so gather everything that is due beforehand
+        std::vector<ScheduleEntry> due;
+        while (!schedule_.empty() && schedule_.front().first <= period.end) {
+            std::pop_heap(schedule_.begin(), schedule_.end(), std::greater<>{});
+            auto entry = schedule_.back();
+            schedule_.pop_back();
+
+            if (isCurrent(entry) && (due.empty() || due.back() != entry)) {
+                due.push_back(entry);
+            }
+        }
+
+        if (pool_ && due.size() > 1) {
+            updateParallel(due, period);
+            return;
+        }
+
+        for (const auto& [date, id] : due) {
+            if (const auto* slot = findSlot(id)) {
+                // Run a copy, since the callback may register or deregister others and move the stored one
+                auto callback = callbacks_[slot->dense];
+                callback(period);
+            }
+        }
+
+        // Anything which did not reschedule itself remains due
+        for (const auto& entry : due) {
+            if (isCurrent(entry)) {
+                pushSchedule(entry.first, entry.second);
+            }
         }
     }
 
 private:
-    static int makeUniqueId() {
-        auto iter = std::max_element(callbacks_.begin(), callbacks_.end(),
-                                     [](auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
-        if (iter == callbacks_.end()) {
-            return 0;
+    using ScheduleEntry = std::pair<Date, int>;
+
+    static void updateParallel(const std::vector<ScheduleEntry>& due, DatePeriod period) {
+        // Several ranges per thread, so threads which finish early have something to steal
+        const std::size_t grain = std::max<std::size_t>(due.size() / (pool_->size() * 8), 1);
+
+        std::exception_ptr error;
+        runningParallel_ = true;
+        try {
+            // Storage is not modified until every callback has finished, so there is no need to copy them
+            pool_->parallelFor(due.size(), grain, [&](std::size_t i) {
+                const auto* slot = findSlot(due[i].second);
+                callbacks_[slot->dense](period);
+            });
+        } catch (...) {
+            error = std::current_exception();
+        }
+        runningParallel_ = false;
+
+        // Covers both callbacks which rescheduled themselves and those which remain due
+        for (const auto& [date, id] : due) {
+            if (const auto* slot = findSlot(id)) {
+                pushSchedule(nextDue_[slot->dense], id);
+            }
         }
 
-        int val = iter->first;
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
 
-        util::ctassert(val < std::numeric_limits<int>::max(), "Id's are out of range of int");
+    struct Slot
+    {
+        std::uint32_t dense = FREE;
+        std::uint32_t generation = 0;
+    };
+
+    static constexpr std::uint32_t MAX_INDEX = (1U << INDEX_BITS) - 1;
+    // Leaves the sign bit clear, so ids are never negative. Generations wrap around quickly, but a stale schedule entry
+    // which then matches a slot is still skipped by its date, see isCurrent.
+    static constexpr std::uint32_t GENERATION_MASK = (1U << (31 - INDEX_BITS)) - 1;
+    static constexpr std::uint32_t FREE = std::numeric_limits<std::uint32_t>::max();
+
+    static int makeId(std::uint32_t index, std::uint32_t generation) {
+        return static_cast<int>((generation << INDEX_BITS) | index);
+    }
+    static std::uint32_t indexOf(int id) { return static_cast<std::uint32_t>(id) & MAX_INDEX; }
+    static std::uint32_t generationOf(int id) { return static_cast<std::uint32_t>(id) >> INDEX_BITS; }
+
+    //! Returns whether the date changed
+    static bool setNextDue(int id, Date nextDue) {
+        auto* slot = findSlot(id);
+        util::ctassert(slot != nullptr, "Attempting to schedule an unregistered function");
 
-        return val + 1;
+        auto& due = nextDue_[slot->dense];
+        if (due == nextDue) {
+            return false;
+        }
+
+        due = nextDue;
+        return true;
+    }
+
+    static Slot* findSlot(int id) {
+        if (id < 0 || indexOf(id) >= slots_.size()) {
+            return nullptr;
+        }
+
+        auto& slot = slots_[indexOf(id)];
+        if (slot.dense == FREE || slot.generation != generationOf(id)) {
+            return nullptr;
+        }
+        return &slot;
     }
 
-    inline static std::map<int, CallbackType> callbacks_; // NOLINT
+    // Rescheduling leaves the old entry behind in the heap, which is skipped once it no longer matches
+    static bool isCurrent(const ScheduleEntry& entry) {
+        const auto* slot = findSlot(entry.second);
+        return slot != nullptr && nextDue_[slot->dense] == entry.first;
+    }
+
+    static void pushSchedule(Date when, int id) {
+        // Drop stale entries once they outnumber the live ones
+        if (schedule_.size() >= 2 * callbacks_.size() + 64) {
+            schedule_.clear();
+            for (std::size_t i = 0; i < callbacks_.size(); ++i) {
+                schedule_.emplace_back(nextDue_[i], makeId(owners_[i], slots_[owners_[i]].generation));
+            }
+            std::make_heap(schedule_.begin(), schedule_.end(), std::greater<>{});
+
+            if (isCurrent({when, id})) {
+                return;
+            }
+        }
+
+        schedule_.emplace_back(when, id);
+        std::push_heap(schedule_.begin(), schedule_.end(), std::greater<>{});
+    }
+
+    inline static std::vector<Slot> slots_;              // NOLINT
+    inline static std::vector<std::uint32_t> freeSlots_; // NOLINT
+    // Indexed by each slot's `dense` position
+    inline static std::vector<CallbackType> callbacks_; // NOLINT
+    inline static std::vector<Date> nextDue_;           // NOLINT
+    inline static std::vector<std::uint32_t> owners_;   // NOLINT
+    // Min-heap on the date each entry is due
+    inline static std::vector<ScheduleEntry> schedule_; // NOLINT
+
+    // Guards registration and scheduling against each other, but not against updates
+    inline static std::mutex mutex_;                       // NOLINT
+    inline static std::unique_ptr<util::ThreadPool> pool_; // NOLINT
+    inline static std::atomic<bool> runningParallel_;      // NOLINT
 };
 
 } // namespace detail
@@ -142,11 +398,7 @@ class RealTimeManager : public detail::Registry<RealTimeManager>
 public:
     static void updateAll() {
         auto date = getDate();
-        // clang-format off
-        detail::Registry<RealTimeManager>::updateAll([&](int /*id*/, auto& callback) {
-            callback(DatePeriod{lastUpdate_, date});
-        });
-        // clang-format on
+        detail::Registry<RealTimeManager>::updateDue(DatePeriod{lastUpdate_, date});
 
         lastUpdate_ = date;
     }
@@ -167,19 +419,17 @@ class SimTimeManager : public detail::Registry<SimTimeManager>
 {
 public:
     static void updateAll() {
-        // clang-format off
-        detail::Registry<SimTimeManager>::updateAll([](int /*id*/, auto& callback) {
-            callback(DatePeriod{lastUpdate_, date_});
-        });
-        // clang-format on
+        detail::Registry<SimTimeManager>::updateDue(DatePeriod{lastUpdate_, date_});
 
         lastUpdate_ = date_;
     }
 
     static Date getDate() { return date_; }
+    //! The date through which accounts have been updated
+    static Date getLastUpdate() { return lastUpdate_; }
 
     static void incrDay(std::chrono::days amt = std::chrono::days{1}) {
-        date_ = Date{std::chrono::sys_days{date_.get()} + amt};
+        date_ = date_ + amt;
     }
 
     static void resetDay() {
@@ -187,6 +437,12 @@ public:
         lastUpdate_ = date_;
     }
 
+    //! Puts the clock back in a state saved with @ref getDate and @ref getLastUpdate
+    static void restore(Date date, Date lastUpdate) {
+        date_ = date;
+        lastUpdate_ = lastUpdate;
+    }
+
     friend class TimeManagerResource;
 
 private:
@@ -200,6 +456,9 @@ private:
  * Semantic requirement: Time moves in one direction--forwards. In other words,
  * each subsequent call to @ref getDay() must return a @ref Date the same as or
  * past the point in time returned by the previous calls.
+ *
+ * Registered callbacks need only be run once the date they were last scheduled
+ * for has been reached.
  */
 template <typename T>
 concept TimeManager = std::is_empty_v<T> && requires {
@@ -208,6 +467,8 @@ concept TimeManager = std::is_empty_v<T> && requires {
         T::registerFn([](DatePeriod) -> void {})
     } -> std::same_as<int>;
     { T::deregisterFn(100) };
+    { T::rebindFn(100, [](DatePeriod) -> void {}) };
+    { T::scheduleFn(100, Date{}) };
     { T::updateAll() };
     { T::getDate() } -> std::same_as<Date>;
 };
@@ -221,68 +482,104 @@ public:
     using CallbackType = std::function<void(DatePeriod)>;
 
     template <TimeManager TimeMngT>
-    TimeManagerResource(TimeMngT /*manager*/, CallbackType updateCallback)
-        : getDateFn_{[] { return TimeMngT::getDate(); }}
-        , registerFn_{TimeMngT::registerFn}
-        , deregisterFn_{TimeMngT::deregisterFn}
-        , callbackFn_{std::move(updateCallback)} {
-        registerHelper();
+    TimeManagerResource(TimeMngT /*manager*/, const CallbackType& updateCallback)
+        : ops_{&OPS<TimeMngT>} {
+        id_ = ops_->registerFn(updateCallback);
+    }
+
+    TimeManagerResource(TimeManagerResource&& other) noexcept
+        : id_{std::exchange(other.id_, -1)}
+        , nextEvent_{other.nextEvent_}
+        , ops_{other.ops_} {}
+
+    /**
+     * @brief Takes over the registration of `other`, which will run `updateCallback` from now on.
+     *
+     * Owners capture `this` in their callback, so this must be used whenever they are moved.
+     */
+    TimeManagerResource(TimeManagerResource&& other, const CallbackType& updateCallback)
+        : TimeManagerResource(std::move(other)) {
+        if (id_ >= 0) {
+            ops_->rebindFn(id_, updateCallback);
+        }
     }
 
-    TimeManagerResource(TimeManagerResource&& other) = default;
     TimeManagerResource& operator=(const TimeManagerResource&) = delete;
     TimeManagerResource& operator=(TimeManagerResource&& rhs) noexcept {
-        if (id_ >= 0) {
-            deregisterFn_(id_);
-            id_ = -1;
+        if (&rhs == this) {
+            return *this;
         }
 
+        release();
         swap(*this, rhs);
         return *this;
     }
-    ~TimeManagerResource() {
-        if (id_ >= 0) {
-            deregisterFn_(id_);
-            id_ = -1;
-        }
-    }
+    ~TimeManagerResource() { release(); }
 
     TimeManagerResource clone(const CallbackType& newCallback) const {
         TimeManagerResource copy{*this};
 
-        copy.callbackFn_ = newCallback;
-        copy.registerHelper();
+        copy.id_ = copy.ops_->registerFn(newCallback);
 
         return copy;
     }
 
-    Date getDate() { return getDateFn_(); }
+    Date getDate() const { return ops_->getDate(); }
+
+    /**
+     * @brief Lets the time manager know the next date on which the owner has anything to do.
+     *
+     * Until then, the owner's callback may be skipped by updates.
+     */
+    void reschedule(Date nextEvent) {
+        if (id_ < 0 || nextEvent == nextEvent_) {
+            return;
+        }
+
+        nextEvent_ = nextEvent;
+        ops_->scheduleFn(id_, nextEvent);
+    }
 
     friend void swap(TimeManagerResource& first, TimeManagerResource& second) noexcept {
         using std::swap;
 
         swap(first.id_, second.id_);
-        swap(first.registerFn_, second.registerFn_);
-        swap(first.deregisterFn_, second.deregisterFn_);
-        swap(first.callbackFn_, second.callbackFn_);
+        swap(first.nextEvent_, second.nextEvent_);
+        swap(first.ops_, second.ops_);
     }
 
 private:
-    // Copying is only allowed as a helper internally for `clone`, since it could refer
-    // to a class member function which is going out of scope.
+    // The time manager functions are all static, so one table per time manager type is shared by every resource
+    struct Ops
+    {
+        Date (*getDate)();
+        int (*registerFn)(const CallbackType&);
+        void (*deregisterFn)(int);
+        void (*rebindFn)(int, const CallbackType&);
+        void (*scheduleFn)(int, Date);
+    };
+
+    template <TimeManager TimeMngT>
+    static constexpr Ops OPS{
+        .getDate = [] { return TimeMngT::getDate(); },
+        .registerFn = [](const CallbackType& callback) { return TimeMngT::registerFn(callback); },
+        .deregisterFn = [](int id) { TimeMngT::deregisterFn(id); },
+        .rebindFn = [](int id, const CallbackType& callback) { TimeMngT::rebindFn(id, callback); },
+        .scheduleFn = [](int id, Date nextDue) { TimeMngT::scheduleFn(id, nextDue); },
+    };
+
+    // Copying is only allowed as a helper internally for `clone`, since the copy needs its own registration.
     TimeManagerResource(const TimeManagerResource& other)
-        : getDateFn_{other.getDateFn_}
-        , registerFn_{other.registerFn_}
-        , deregisterFn_{other.deregisterFn_}
-        , callbackFn_{other.callbackFn_} {}
+        : ops_{other.ops_} {}
 
-    void registerHelper() {
-        id_ = registerFn_([&](DatePeriod period) { callbackFn_(period); });
+    void release() {
+        if (id_ >= 0) {
+            ops_->deregisterFn(id_);
+            id_ = -1;
+        }
     }
 
-    int id_{};
-    std::function<Date()> getDateFn_;
-    std::function<int(const CallbackType&)> registerFn_;
-    std::function<void(int)> deregisterFn_;
-    CallbackType callbackFn_;
+    int id_{-1};
+    Date nextEvent_;
+    const Ops* ops_;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace util {
+
+/**
+ * @brief Buffer for constructing an object in place, falling back to the heap for types which do not fit.
+ *
+ * Meant to be embedded in a type-erasing wrapper, which keeps a pointer to whatever was constructed.
+ */
+template <std::size_t Capacity>
+class InlineStorage
+{
+public:
+    // Must be nothrow movable as well, since moving the owning wrapper moves the object between buffers
+    template <typename T>
+    static constexpr bool fits = sizeof(T) <= Capacity && alignof(T) <= alignof(std::max_align_t) &&
+                                 std::is_nothrow_move_constructible_v<T>;
+
+    InlineStorage() = default;
+    // The owner decides what to do with the contents
+    InlineStorage(const InlineStorage&) = delete;
+    InlineStorage(InlineStorage&&) = delete;
+    InlineStorage& operator=(const InlineStorage&) = delete;
+    InlineStorage& operator=(InlineStorage&&) = delete;
+    ~InlineStorage() = default;
+
+    template <typename T, typename... Args>
+    T* construct(Args&&... args) {
+        if constexpr (fits<T>) {
+            return ::new (static_cast<void*>(buffer_)) T(std::forward<Args>(args)...);
+        } else {
+            return new T(std::forward<Args>(args)...);
+        }
+    }
+
+    //! Whether `ptr` points into this buffer rather than to the heap
+    bool holds(const void* ptr) const {
+        const auto* addr = static_cast<const std::byte*>(ptr);
+        return std::less_equal<>{}(buffer_, addr) && std::less<>{}(addr, buffer_ + Capacity);
+    }
+
+    //! Destroys an object made by @ref construct, which may be referred to through a base with a virtual destructor
+    template <typename T>
+    void destroy(T* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+
+        if (holds(ptr)) {
+            std::destroy_at(ptr);
+        } else {
+            delete ptr;
+        }
+    }
+
+private:
+    alignas(std::max_align_t) std::byte buffer_[Capacity]; // NOLINT(*c-arrays)
+};
+
+} // namespace util
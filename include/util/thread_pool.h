@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace util {
+
+/**
+ * @brief Fixed set of threads for splitting a loop over indices, with work stealing.
+ *
+ * Each participant is handed a contiguous block of index ranges up front. Once its own block runs out it takes ranges
+ * from the other end of another participant's block, so uneven per-index costs still keep every thread busy. The
+ * calling thread takes part in every loop.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * @param numThreads Total number of threads to run loops on, including the caller
+     */
+    explicit ThreadPool(std::size_t numThreads)
+        : queues_(std::max<std::size_t>(numThreads, 1)) {
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            workers_.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::scoped_lock lock{mutex_};
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    std::size_t size() const { return queues_.size(); }
+
+    /**
+     * @brief Calls `func(i)` for every `i` in `[0, count)`, returning once all calls have finished.
+     *
+     * Indices are handed out in ranges of `grain`. If any call throws, the remaining indices are still run and the
+     * first exception is rethrown afterwards.
+     */
+    template <typename Func>
+    void parallelFor(std::size_t count, std::size_t grain, Func&& func) {
+        if (count == 0) {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+
+        const std::function<void(std::size_t)> job = std::forward<Func>(func);
+
+        {
+            std::scoped_lock lock{mutex_};
+
+            const std::size_t numRanges = (count + grain - 1) / grain;
+            const std::size_t perQueue = (numRanges + queues_.size() - 1) / queues_.size();
+            for (std::size_t range = 0; range < numRanges; ++range) {
+                const std::size_t begin = range * grain;
+                queues_[range / perQueue].ranges.push_back({begin, std::min(begin + grain, count)});
+            }
+
+            job_ = &job;
+            error_ = nullptr;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        runRanges(0, job);
+
+        std::exception_ptr error;
+        {
+            std::unique_lock lock{mutex_};
+            done_.wait(lock, [this] { return active_ == 0; });
+            job_ = nullptr;
+            error = std::exchange(error_, nullptr);
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct Range
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    bool takeRange(std::size_t self, Range& out) {
+        for (std::size_t offset = 0; offset < queues_.size(); ++offset) {
+            auto& queue = queues_[(self + offset) % queues_.size()];
+            std::scoped_lock lock{queue.mutex};
+            if (queue.ranges.empty()) {
+                continue;
+            }
+
+            // Work through our own block from the back and steal from the front of others, to keep out of each
+            // other's way
+            if (offset == 0) {
+                out = queue.ranges.back();
+                queue.ranges.pop_back();
+            } else {
+                out = queue.ranges.front();
+                queue.ranges.pop_front();
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    void runRanges(std::size_t self, const std::function<void(std::size_t)>& job) {
+        Range range{};
+        while (takeRange(self, range)) {
+            for (std::size_t i = range.begin; i < range.end; ++i) {
+                try {
+                    job(i);
+                } catch (...) {
+                    std::scoped_lock lock{mutex_};
+                    if (!error_) {
+                        error_ = std::current_exception();
+                    }
+                }
+            }
+        }
+    }
+
+    void workerLoop(std::size_t self) {
+        std::uint64_t seen = 0;
+
+        while (true) {
+            const std::function<void(std::size_t)>* job = nullptr;
+            {
+                std::unique_lock lock{mutex_};
+                wake_.wait(lock, [&] { return stopping_ || (generation_ != seen && job_ != nullptr); });
+                if (stopping_) {
+                    return;
+                }
+
+                seen = generation_;
+                job = job_;
+                ++active_;
+            }
+
+            runRanges(self, *job);
+
+            {
+                std::scoped_lock lock{mutex_};
+                --active_;
+            }
+            done_.notify_all();
+        }
+    }
+
+    std::vector<Queue> queues_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(std::size_t)>* job_ = nullptr;
+    std::uint64_t generation_ = 0;
+    std::size_t active_ = 0;
+    std::exception_ptr error_;
+    bool stopping_ = false;
+};
+
+} // namespace util
@@ -4,13 +4,14 @@
 
 #include <fmt/format.h>
 
-#include <algorithm>
 #include <array>
+#include <concepts>
+#include <cstddef>
 #include <cstdint>
-#include <iterator>
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
 // NOLINTBEGIN(*pointer-arithmetic)
@@ -103,34 +104,69 @@ static_assert(std::is_same_v<retain_const_t<int, char>, char>);
 static_assert(std::is_same_v<retain_const_t<const int, char&>, const char&>);
 static_assert(std::is_same_v<retain_const_t<int, char&>, char&>);
 
-template <std::integral IntType>
-struct CommaSeperated
-{
-    const IntType& inner; // NOLINT
-};
+namespace detail {
 
-template <std::integral IntType>
-// NOLINTNEXTLINE(*identifier-naming)
-auto format_as(CommaSeperated<IntType> value) {
-    std::string result;
-    std::array<int, std::numeric_limits<IntType>::digits10> digits{};
-    std::size_t numDigits = 0;
-    for (auto val = value.inner; val > 0; val /= 10) {
-        digits.at(numDigits) = static_cast<int>(val % 10);
-        ++numDigits;
+// "00", "01", ..., "99" back to back, so two digits are converted at a time
+constexpr std::array<char, 200> DIGIT_PAIRS = [] {
+    std::array<char, 200> pairs{};
+    for (std::size_t i = 0; i < 100; ++i) {
+        pairs.at(2 * i) = static_cast<char>('0' + i / 10);
+        pairs.at(2 * i + 1) = static_cast<char>('0' + i % 10);
     }
+    return pairs;
+}();
 
-    for (std::size_t i = 0; i < numDigits; ++i) {
-        char val = static_cast<char>('0' + digits.at(i));
+} // namespace detail
 
-        if (i != 0 && i % 3 == 0) {
-            result += std::string{","} + val;
-        }
+//! Longest text @ref writeGrouped produces: the 20 digits of the largest 64-bit value and 6 commas
+constexpr std::size_t MAX_GROUPED_CHARS = std::numeric_limits<std::uint64_t>::digits10 + 1 + 6;
 
-        result += std::string{val};
+// NOLINTBEGIN(*pointer-arithmetic)
+//! Writes the last two decimal digits of `value`, zero padded, ending at `end`. Returns where they start.
+constexpr char* writeDigitPair(std::uint64_t value, char* end) {
+    const auto pair = static_cast<std::size_t>(value % 100) * 2;
+    *--end = detail::DIGIT_PAIRS[pair + 1];
+    *--end = detail::DIGIT_PAIRS[pair];
+    return end;
+}
+
+//! Writes `value` in decimal with commas between groups of three digits, ending at `end`. Returns where it starts.
+constexpr char* writeGrouped(std::uint64_t value, char* end) {
+    for (; value >= 1000; value /= 1000) {
+        const auto group = value % 1000;
+        end = writeDigitPair(group, end);
+        *--end = static_cast<char>('0' + group / 100);
+        *--end = ',';
     }
-    std::reverse(result.begin(), result.end());
-    return result;
+    if (value >= 100) {
+        end = writeDigitPair(value, end);
+        *--end = static_cast<char>('0' + value / 100);
+        return end;
+    }
+    if (value >= 10) {
+        return writeDigitPair(value, end);
+    }
+    *--end = static_cast<char>('0' + value);
+    return end;
 }
+// NOLINTEND(*pointer-arithmetic)
+
+template <std::unsigned_integral IntType>
+struct CommaSeperated
+{
+    const IntType& inner; // NOLINT
+};
 
 } // namespace util
+
+template <std::unsigned_integral IntType>
+struct fmt::formatter<util::CommaSeperated<IntType>> : formatter<std::string_view>
+{
+    template <typename FormatCtx>
+    FormatCtx::iterator format(util::CommaSeperated<IntType> value, FormatCtx& ctx) const {
+        std::array<char, util::MAX_GROUPED_CHARS> buffer{};
+        const char* start = util::writeGrouped(value.inner, buffer.data() + buffer.size());
+        return formatter<std::string_view>::format(
+            std::string_view{start, static_cast<std::size_t>(buffer.data() + buffer.size() - start)}, ctx);
+    }
+};
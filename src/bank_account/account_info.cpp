@@ -1,56 +1,194 @@
 #include "account_info.h"
 #include "monthly_statement.h"
+#include "statement_archive.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Accounts may be created from several threads at once
+std::atomic<int> nextAccountNum = 0; // NOLINT(*non-const-global-variables)
+
+bool startsBefore(const StoredStatement& statement, std::int32_t month) {
+    return statement.month() < month;
+}
+
+} // namespace
 
 AccountInfo::AccountInfo(std::string_view holderName, Money startingBalance, Date openingDate)
     : balance_(startingBalance)
     , holderName_(holderName)
     , number_(generateNextAccountNum())
-    , openingDate_(openingDate) {}
+    , openingDate_(openingDate)
+    , lastMonth_(openingDate.monthIndex() - 1) {}
 
-const MonthlyStatement& AccountInfo::getMonthlyStatement(Date when) const {
-    return getStatementHelper(*this, when);
-}
+AccountInfo::AccountInfo(int number, std::string_view holderName, Money balance, Date openingDate,
+                         std::int32_t lastMonth, std::vector<StoredStatement> statements)
+    : balance_(balance)
+    , holderName_(holderName)
+    , number_(number)
+    , openingDate_(openingDate)
+    , monthlyStatements_(std::move(statements))
+    , lastMonth_(lastMonth) {}
 
-void AccountInfo::addStatementsThrough(Date when) {
-    auto monthsSinceOpening =
-        static_cast<std::size_t>(Date::diff<std::chrono::months>(Date{getMonthStart(openingDate_.get())}, when));
-    auto originalSize = monthlyStatements_.size();
+MonthlyStatement AccountInfo::getMonthlyStatement(Date when) const {
+    const auto month = when.monthIndex();
+    if (month < openingDate_.monthIndex() || month > lastMonth_) {
+        throw std::out_of_range("No monthly statement for the given date");
+    }
+
+    if (const auto* stored = findStatement(when)) {
+        return *stored->load();
+    }
 
-    int numNew = static_cast<int>(monthsSinceOpening - originalSize + 1);
+    const auto start = Date::fromMonthIndex(month);
+    return MonthlyStatement{.start = start, .end = start.monthEnd(), .records = {}, .complete = month != lastMonth_};
+}
 
-    if (numNew <= 0) {
+void AccountInfo::addStatementsThrough(Date when) {
+    const auto month = when.monthIndex();
+    if (month <= lastMonth_) {
         return;
     }
 
-    if (originalSize > 0) {
-        monthlyStatements_.back().complete = true;
+    // Months in between are empty, so there is nothing to store for them
+    if (monthlyStatements_ && !monthlyStatements_->empty() && monthlyStatements_->back().month() == lastMonth_) {
+        monthlyStatements_.mutate().back().mutate().complete = true;
     }
+    lastMonth_ = month;
+    archiveStatements();
+}
 
-    for (int i = 0; i < numNew; ++i) {
-        std::chrono::year_month_day startDate{};
-        if (monthlyStatements_.empty()) {
-            startDate = getMonthStart(openingDate_.get());
-        } else {
-            startDate = monthlyStatements_.back().start.get() + std::chrono::months{1};
+void AccountInfo::addToMonthlyStatement(Date when, StatementRecordInfo info) {
+    // Records nearly always go to the open month, which can be checked for without any month arithmetic
+    if (monthlyStatements_ && !monthlyStatements_->empty()) {
+        const auto* latest = monthlyStatements_->back().resident();
+        if (latest != nullptr && !latest->complete && latest->start <= when && when <= latest->end) {
+            monthlyStatements_.mutate().back().mutate().records.emplace(when, std::move(info));
+            return;
         }
+    }
 
-        monthlyStatements_.emplace_back(
-            // NOLINTNEXTLINE: A little more readable this way
-            MonthlyStatement{
-                .start = Date{startDate}, .end = Date{getMonthEnd(startDate)}, .records = {}, .complete = true});
+    statementFor(when).records.emplace(when, std::move(info));
+}
+
+const StatementRecords& AccountInfo::reserveRecords(Date when, std::size_t count) {
+    auto& records = statementFor(when).records;
+    // Growing only by what is needed would reallocate on every batch
+    const auto needed = records.size() + count;
+    if (needed > records.capacity()) {
+        records.reserve(std::max(needed, records.capacity() * 2));
     }
+    return records;
+}
 
-    monthlyStatements_.back().complete = false;
+const StatementRecordInfo& AccountInfo::markTransfer(Date when, StatementRecordInfo::Event event, int counterparty) {
+    auto& record = statementFor(when).records.lastOn(when);
+    record.event = event;
+    record.counterparty = counterparty;
+    return record;
 }
-void AccountInfo::addToMonthlyStatement(Date when, StatementRecordInfo info) {
+
+MonthlyStatement& AccountInfo::statementFor(Date when) {
     addStatementsThrough(when);
-    getStatementHelper(*this, when).records.emplace(when, std::move(info));
+
+    const auto month = when.monthIndex();
+    auto& statements = monthlyStatements_.mutate();
+    auto iter = statements.end();
+    // Records are nearly always for the latest month, so only search when they are not
+    if (!statements.empty() && statements.back().month() >= month) {
+        iter = std::lower_bound(statements.begin(), statements.end(), month, startsBefore);
+    }
+
+    if (iter == statements.end() || iter->month() != month) {
+        const auto start = when.monthStart();
+        iter = statements.insert(
+            iter,
+            // NOLINTNEXTLINE: A little more readable this way
+            StoredStatement{MonthlyStatement{
+                .start = start, .end = start.monthEnd(), .records = {}, .complete = month != lastMonth_}});
+    }
+
+    return iter->mutate();
+}
+
+const StoredStatement* AccountInfo::findStatement(Date when) const {
+    if (!monthlyStatements_) {
+        return nullptr;
+    }
+
+    const auto month = when.monthIndex();
+    auto iter = std::lower_bound(monthlyStatements_->begin(), monthlyStatements_->end(), month, startsBefore);
+
+    if (iter == monthlyStatements_->end() || iter->month() != month) {
+        return nullptr;
+    }
+    return &*iter;
+}
+
+void AccountInfo::archiveStatements() {
+    if (!monthlyStatements_) {
+        return;
+    }
+    const auto archive = StatementArchive::active();
+    if (archive == nullptr) {
+        return;
+    }
+
+    // Count back from the latest month to the first one beyond the limits. Months before that were archived already,
+    // unless they were changed since.
+    const auto& options = archive->options();
+    const auto& statements = *monthlyStatements_;
+    std::size_t numRecords = 0;
+    auto end = statements.size();
+    for (; end > 0; --end) {
+        const auto& stored = statements[end - 1];
+        if (stored.archived()) {
+            return;
+        }
+        if (!stored.resident()->complete) {
+            continue;
+        }
+
+        numRecords += stored.resident()->records.size();
+        if (lastMonth_ - stored.month() >= options.maxResidentMonths || numRecords > options.maxResidentRecords) {
+            break;
+        }
+    }
+    // Nothing is beyond the limits, so the statements are left shared with any copies of the account
+    if (end == 0) {
+        return;
+    }
+
+    auto& toArchive = monthlyStatements_.mutate();
+    for (auto i = end; i > 0 && !toArchive[i - 1].archived(); --i) {
+        toArchive[i - 1].archiveTo(archive, number_);
+    }
+}
+
+Date AccountInfo::getNextStatementDate() const {
+    if (lastMonth_ < openingDate_.monthIndex()) {
+        return Date{};
+    }
+
+    return Date::fromMonthIndex(lastMonth_ + 1);
 }
 
 int AccountInfo::generateNextAccountNum() {
-    static int number = 0;
+    return nextAccountNum++;
+}
 
-    return number++;
+void AccountInfo::skipAccountNumbersThrough(int number) {
+    int next = nextAccountNum.load();
+    while (next <= number) {
+        if (nextAccountNum.compare_exchange_weak(next, number + 1)) {
+            break;
+        }
+    }
 }
@@ -0,0 +1,270 @@
+#include "batch_runner.h"
+#include "cd_account.h"
+#include "hi_checking_account.h"
+#include "hi_savings_account.h"
+#include "interest_handler.h"
+#include "money_type.h"
+#include "nosc_checking_account.h"
+#include "savings_account.h"
+#include "sc_checking_account.h"
+#include "transaction.h"
+#include "transaction_import.h"
+#include "util/date_util.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+namespace {
+
+constexpr std::size_t MAX_WORDS = 8;
+
+//! Splits `line` into words separated by spaces or tabs, where a word may be quoted to contain them
+/*!
+  Returns how many words were found. Throws std::invalid_argument if there are more than `words` has room for or a
+  quote is left open.
+*/
+std::size_t splitWords(std::string_view line, std::span<std::string_view> words) {
+    std::size_t count = 0;
+    for (;;) {
+        const auto start = line.find_first_not_of(" \t");
+        if (start == std::string_view::npos) {
+            return count;
+        }
+        line.remove_prefix(start);
+        if (count == words.size()) {
+            throw std::invalid_argument("Too many words");
+        }
+
+        std::size_t end = 0;
+        if (line.front() == '"') {
+            end = line.find('"', 1);
+            if (end == std::string_view::npos) {
+                throw std::invalid_argument("Unterminated quote");
+            }
+            words[count++] = line.substr(1, end - 1);
+            ++end;
+        } else {
+            end = std::min(line.find_first_of(" \t"), line.size());
+            words[count++] = line.substr(0, end);
+        }
+        line.remove_prefix(end);
+    }
+}
+
+template <typename Number>
+Number parseNumber(std::string_view text, std::string_view what) {
+    Number value{};
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        throw std::invalid_argument(fmt::format("Invalid {} '{}'", what, text));
+    }
+    return value;
+}
+
+Money parseAmount(std::string_view text) {
+    Money amount;
+    const auto [end, error] = parseMoney(text, amount);
+    if (error != std::errc{} || end != text.data() + text.size()) {
+        throw std::invalid_argument(fmt::format("Invalid amount '{}'", text));
+    }
+    return amount;
+}
+
+void expectWords(std::span<const std::string_view> words, std::size_t count, std::string_view usage) {
+    if (words.size() != count) {
+        throw std::invalid_argument(fmt::format("Usage: {}", usage));
+    }
+}
+
+} // namespace
+
+BatchRunner::BatchRunner(AccountStore<BankAccount>& accounts, std::ostream& output, std::size_t bufferSize)
+    : accounts_{accounts}
+    , output_{output}
+    , bufferSize_{bufferSize} {}
+
+std::size_t BatchRunner::run(std::string_view script) {
+    std::size_t numFailed = 0;
+    std::size_t lineNumber = 0;
+    std::array<std::string_view, MAX_WORDS> words;
+
+    while (!script.empty()) {
+        const auto lineEnd = std::min(script.find('\n'), script.size());
+        auto line = script.substr(0, lineEnd);
+        script.remove_prefix(std::min(lineEnd + 1, script.size()));
+        ++lineNumber;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        const auto start = line.find_first_not_of(" \t");
+        if (start == std::string_view::npos || line[start] == '#') {
+            continue;
+        }
+
+        try {
+            execute(std::span{words}.first(splitWords(line, words)));
+        } catch (const std::exception& error) {
+            renderer_.append("Error on line {}: {}\n", lineNumber, error.what());
+            ++numFailed;
+        }
+
+        if (renderer_.size() >= bufferSize_) {
+            flush();
+        }
+    }
+
+    flush();
+    return numFailed;
+}
+
+std::size_t BatchRunner::run(std::istream& input) {
+    std::ostringstream script;
+    script << input.rdbuf();
+    return run(std::string_view{script.view()});
+}
+
+void BatchRunner::execute(std::span<const std::string_view> words) {
+    const auto command = words.front();
+
+    if (command == "open") {
+        open(words);
+    } else if (command == "deposit") {
+        transact(words, Transaction::Type::Deposit);
+    } else if (command == "withdraw") {
+        transact(words, Transaction::Type::Withdrawal);
+    } else if (command == "check") {
+        transact(words, Transaction::Type::Check);
+    } else if (command == "step") {
+        expectWords(words, 2, "step <days>");
+        const auto days = parseNumber<int>(words[1], "number of days");
+        if (days <= 0) {
+            throw std::invalid_argument("Number of days must be positive");
+        }
+        SimTimeManager::incrDay(std::chrono::days{days});
+        SimTimeManager::updateAll();
+        renderer_.append("Stepped {} days to {:%D}\n", days, SimTimeManager::getDate());
+    } else if (command == "close") {
+        expectWords(words, 2, "close <account>");
+        const int number = account(words[1]).getAccountNumber();
+        accounts_.close(number);
+        // Frees the alias for another account, whether or not the account was named by it here
+        std::erase_if(aliases_, [number](const auto& alias) { return alias.second == number; });
+        renderer_.append("{}: closed\n", number);
+    } else if (command == "info") {
+        expectWords(words, 2, "info <account>");
+        const auto& info = account(words[1]);
+        renderer_.append("{}: owned by {:?}, opened {:%D}, balance {}\n", info.getAccountNumber(),
+                         info.getAccountName(), info.getAccountOpeningDate(), info.getBalance());
+    } else if (command == "statement") {
+        expectWords(words, 2, "statement <account>");
+        renderer_.renderAll(account(words[1]));
+        renderer_.append("\n\n");
+    } else if (command == "import") {
+        expectWords(words, 2, "import <file>");
+        const auto report = importTransactions(std::string{words[1]}, accounts_);
+        renderer_.append("Imported {} rows: {} applied, {} succeeded, {} rejected\n", report.numRows,
+                         report.numApplied, report.numSucceeded, report.numRejected);
+        for (const auto& [line, reason] : report.rejections) {
+            renderer_.append("\tline {}: {}\n", line, reason);
+        }
+    } else if (command == "export") {
+        expectWords(words, 2, "export <file>");
+        exportStatements(std::string{words[1]}, accounts_);
+        renderer_.append("Wrote statements of {} accounts to {}\n", accounts_.size(), words[1]);
+    } else {
+        throw std::invalid_argument(fmt::format("Unknown command '{}'", command));
+    }
+}
+
+void BatchRunner::open(std::span<const std::string_view> words) {
+    constexpr std::string_view USAGE = "open <alias> <type> <holder> <balance> [<rate> [<months> <penalty>]]";
+    if (words.size() < 5) {
+        throw std::invalid_argument(fmt::format("Usage: {}", USAGE));
+    }
+
+    const std::string alias{words[1]};
+    if (alias.empty() || (alias.front() >= '0' && alias.front() <= '9')) {
+        throw std::invalid_argument(fmt::format("Alias '{}' must not be empty or start with a digit", alias));
+    }
+    if (aliases_.contains(alias)) {
+        throw std::invalid_argument(fmt::format("Alias '{}' is already in use", alias));
+    }
+    const auto type = words[2];
+    const auto holder = words[3];
+    const auto balance = parseAmount(words[4]);
+
+    BankAccount* opened = nullptr;
+    if (type == "sc-checking") {
+        expectWords(words, 5, "open <alias> sc-checking <holder> <balance>");
+        opened = &accounts_.insert(ServiceChargeCheckingAccount(holder, balance, SimTimeManager{}));
+    } else if (type == "cd") {
+        expectWords(words, 8, "open <alias> cd <holder> <balance> <rate> <months> <penalty>");
+        const InterestHandler interest(InterestType::Monthly, parseNumber<double>(words[5], "rate"));
+        const std::chrono::months maturity{parseNumber<int>(words[6], "number of months")};
+        const auto penalty = parseNumber<double>(words[7], "penalty");
+        opened = &accounts_.insert(
+            CertificateOfDepositAccount(holder, balance, maturity, penalty, interest, SimTimeManager{}));
+    } else {
+        expectWords(words, 6, "open <alias> <type> <holder> <balance> <rate>");
+        const InterestHandler interest(InterestType::Monthly, parseNumber<double>(words[5], "rate"));
+        if (type == "checking") {
+            opened = &accounts_.insert(NoServiceChargeCheckingAccount(holder, balance, interest, SimTimeManager{}));
+        } else if (type == "hi-checking") {
+            opened = &accounts_.insert(HighInterestCheckingAccount(holder, balance, interest, SimTimeManager{}));
+        } else if (type == "savings") {
+            opened = &accounts_.insert(SavingsAccount(holder, balance, interest, SimTimeManager{}));
+        } else if (type == "hi-savings") {
+            opened = &accounts_.insert(HighInterestSavingsAccount(holder, balance, interest, SimTimeManager{}));
+        } else {
+            throw std::invalid_argument(fmt::format("Unknown account type '{}'", type));
+        }
+    }
+
+    const int number = opened->getAccountNumber();
+    aliases_.emplace(alias, number);
+    renderer_.append("{}: opened {} for {:?} as {}\n", number, type, holder, alias);
+}
+
+void BatchRunner::transact(std::span<const std::string_view> words, Transaction::Type type) {
+    const auto command = words.front();
+    if (words.size() != 3) {
+        throw std::invalid_argument(fmt::format("Usage: {} <account> <amount>", command));
+    }
+    auto& target = account(words[1]);
+    const Transaction transaction{.type = type, .amount = parseAmount(words[2])};
+
+    // Throws std::invalid_argument for a check on an account which does not take them
+    const bool succeeded = target.apply(std::span{&transaction, 1}) == 1;
+    renderer_.append("{}: {} {}{}, balance {}\n", target.getAccountNumber(), command, transaction.amount,
+                     succeeded ? "" : " declined", target.getBalance());
+}
+
+BankAccount& BatchRunner::account(std::string_view name) {
+    int number = 0;
+    if (!name.empty() && name.front() >= '0' && name.front() <= '9') {
+        number = parseNumber<int>(name, "account number");
+    } else if (const auto alias = aliases_.find(std::string{name}); alias != aliases_.end()) {
+        number = alias->second;
+    } else {
+        throw std::invalid_argument(fmt::format("Unknown account '{}'", name));
+    }
+
+    if (auto* found = accounts_.find(number)) {
+        return *found;
+    }
+    throw std::invalid_argument(fmt::format("Account {} is not open", number));
+}
+
+void BatchRunner::flush() {
+    const auto text = renderer_.view();
+    output_.write(text.data(), static_cast<std::streamsize>(text.size()));
+    output_.flush();
+    renderer_.clear();
+}
@@ -3,14 +3,29 @@
 #include "bank_account.h"
 #include "util/date_util.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <utility>
+
 CertificateOfDepositAccount::CertificateOfDepositAccount(const CertificateOfDepositAccount& other)
     : AccountInfo(other)
     , numMaturityMonths_{other.numMaturityMonths_}
+    , isMature_{other.isMature_}
     , interestHandler_{other.interestHandler_}
     , earlyWithdrawalPenalty_{other.earlyWithdrawalPenalty_}
     , lastInterestPayment_{other.lastInterestPayment_}
     , timeManager_(other.timeManager_.clone([this](DatePeriod period) { update(period); })) {}
 
+CertificateOfDepositAccount::CertificateOfDepositAccount(CertificateOfDepositAccount&& other) noexcept
+    : AccountInfo(std::move(other))
+    , numMaturityMonths_{other.numMaturityMonths_}
+    , isMature_{other.isMature_}
+    , interestHandler_{other.interestHandler_}
+    , earlyWithdrawalPenalty_{other.earlyWithdrawalPenalty_}
+    , lastInterestPayment_{other.lastInterestPayment_}
+    , timeManager_(std::move(other.timeManager_), [this](DatePeriod period) { update(period); }) {}
+
 CertificateOfDepositAccount& CertificateOfDepositAccount::operator=(const CertificateOfDepositAccount& rhs) {
     if (&rhs == this) {
         return *this;
@@ -21,13 +36,29 @@ CertificateOfDepositAccount& CertificateOfDepositAccount::operator=(const Certif
     return *this;
 }
 
+CertificateOfDepositAccount& CertificateOfDepositAccount::operator=(CertificateOfDepositAccount&& rhs) noexcept {
+    if (&rhs == this) {
+        return *this;
+    }
+
+    AccountInfo::operator=(std::move(rhs));
+    numMaturityMonths_ = rhs.numMaturityMonths_;
+    isMature_ = rhs.isMature_;
+    interestHandler_ = rhs.interestHandler_;
+    earlyWithdrawalPenalty_ = rhs.earlyWithdrawalPenalty_;
+    lastInterestPayment_ = rhs.lastInterestPayment_;
+    timeManager_ = TimeManagerResource{std::move(rhs.timeManager_), [this](DatePeriod period) { update(period); }};
+    return *this;
+}
+
 void CertificateOfDepositAccount::update(DatePeriod period) {
     addStatementsThrough(period.end);
     if (isMature_) {
+        timeManager_.reschedule(getNextEventDate());
         return;
     }
 
-    interestHandler_.processDuring(period.begin, period.end, [this](Date when, double rate) {
+    interestHandler_.processDuring(period.begin, period.end, [this](Date when, Rate rate) {
         if (isMature_) {
             return;
         }
@@ -35,7 +66,8 @@ void CertificateOfDepositAccount::update(DatePeriod period) {
         auto interestAmount = getBalance() * rate;
         balance_ += interestAmount;
         addToMonthlyStatement(when, {
-                                        .details = fmt::format("Accumulated interest at {:.2f}%", rate * 100),
+                                        .event = StatementRecordInfo::Event::Interest,
+                                        .rate = rate,
                                         .balanceChange = interestAmount,
                                         .changeType = StatementRecordInfo::Increase,
                                         .resultantBalance = getBalance(),
@@ -43,40 +75,67 @@ void CertificateOfDepositAccount::update(DatePeriod period) {
 
         if (Date::diff<std::chrono::months>(getAccountOpeningDate(), when) >= numMaturityMonths_) {
             isMature_ = true;
-            addToMonthlyStatement(Date{getAccountOpeningDate().get() + std::chrono::months{numMaturityMonths_}},
+            addToMonthlyStatement(getAccountOpeningDate() + std::chrono::months{numMaturityMonths_},
                                   {
-                                      .details = "CD Account fully matured",
+                                      .event = StatementRecordInfo::Event::Matured,
                                       .balanceChange = 0_dollars,
                                       .changeType = StatementRecordInfo::None,
                                       .resultantBalance = getBalance(),
                                   });
         }
     });
+
+    timeManager_.reschedule(getNextEventDate());
+}
+
+Date CertificateOfDepositAccount::getNextEventDate() const {
+    if (isMature_) {
+        return getNextStatementDate();
+    }
+
+    return std::min(interestHandler_.getNextPayoutDate(), getNextStatementDate());
+}
+
+void CertificateOfDepositAccount::deposit(Money amount) {
+    depositOn(timeManager_.getDate(), amount);
 }
 
-void CertificateOfDepositAccount::deposit(Money /*amount*/) {}
 void CertificateOfDepositAccount::withdraw(Money amount) {
-    std::string statementInfo{};
+    withdrawOn(timeManager_.getDate(), amount);
+}
 
+std::size_t CertificateOfDepositAccount::apply(std::span<const Transaction> batch) {
+    return applyBatch(*this, timeManager_.getDate(), batch);
+}
+
+bool CertificateOfDepositAccount::transferOut(Money amount, int to) {
+    return transferOutOn(*this, timeManager_.getDate(), amount, to);
+}
+
+void CertificateOfDepositAccount::transferIn(Money amount, int from) {
+    transferIntoOn(*this, timeManager_.getDate(), amount, from);
+}
+
+void CertificateOfDepositAccount::depositOn(Date /*when*/, Money /*amount*/) {}
+void CertificateOfDepositAccount::withdrawOn(Date when, Money amount) {
     auto penalty = amount * earlyWithdrawalPenalty_;
     auto fullAmount = isMature_ ? amount : amount + penalty;
 
     bool canWithdraw = fullAmount <= getBalance();
+    auto outcome = StatementRecordInfo::Outcome::InsufficientFunds;
 
-    if (canWithdraw && isMature_) {
-        balance_ -= fullAmount;
-        statementInfo = fmt::format("Successful withdrawal");
-    } else if (canWithdraw) {
+    if (canWithdraw) {
         balance_ -= fullAmount;
-        statementInfo = fmt::format("Successful withdrawal of {} with penalty of {}", amount, penalty);
-    } else {
-        statementInfo = fmt::format("Failed to withdraw {}", amount);
+        outcome = isMature_ ? StatementRecordInfo::Outcome::Success : StatementRecordInfo::Outcome::SuccessWithPenalty;
     }
 
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = statementInfo,
-                                                      .balanceChange = canWithdraw ? amount : 0_dollars,
-                                                      .changeType = StatementRecordInfo::Decrease,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+    addToMonthlyStatement(when, {
+                                    .event = StatementRecordInfo::Event::Withdrawal,
+                                    .outcome = outcome,
+                                    .amount = amount,
+                                    .rate = earlyWithdrawalPenalty_,
+                                    .balanceChange = canWithdraw ? amount : 0_dollars,
+                                    .changeType = StatementRecordInfo::Decrease,
+                                    .resultantBalance = getBalance(),
+                                });
 }
@@ -2,11 +2,21 @@
 #include "money_type.h"
 #include "util/date_util.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <utility>
+
 HighInterestCheckingAccount::HighInterestCheckingAccount(const HighInterestCheckingAccount& other)
     : AccountInfo(other)
     , interestHandler_{other.interestHandler_}
     , timeManager_(other.timeManager_.clone([this](DatePeriod period) { update(period); })) {}
 
+HighInterestCheckingAccount::HighInterestCheckingAccount(HighInterestCheckingAccount&& other) noexcept
+    : AccountInfo(std::move(other))
+    , interestHandler_{other.interestHandler_}
+    , timeManager_(std::move(other.timeManager_), [this](DatePeriod period) { update(period); }) {}
+
 HighInterestCheckingAccount& HighInterestCheckingAccount::operator=(const HighInterestCheckingAccount& rhs) {
     if (&rhs == this) {
         return *this;
@@ -17,49 +27,84 @@ HighInterestCheckingAccount& HighInterestCheckingAccount::operator=(const HighIn
     return *this;
 }
 
+HighInterestCheckingAccount& HighInterestCheckingAccount::operator=(HighInterestCheckingAccount&& rhs) noexcept {
+    if (&rhs == this) {
+        return *this;
+    }
+
+    AccountInfo::operator=(std::move(rhs));
+    interestHandler_ = rhs.interestHandler_;
+    timeManager_ = TimeManagerResource{std::move(rhs.timeManager_), [this](DatePeriod period) { update(period); }};
+    return *this;
+}
+
 void HighInterestCheckingAccount::deposit(Money amount) {
-    balance_ += amount;
+    depositOn(timeManager_.getDate(), amount);
+}
 
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = "Successful deposit",
-                                                      .balanceChange = amount,
-                                                      .changeType = StatementRecordInfo::Increase,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+void HighInterestCheckingAccount::withdraw(Money amount) {
+    withdrawOn(timeManager_.getDate(), amount);
 }
 
 void HighInterestCheckingAccount::writeCheck(Money amount) {
-    withdrawHelper(amount, "check");
+    writeCheckOn(timeManager_.getDate(), amount);
 }
 
-void HighInterestCheckingAccount::withdraw(Money amount) {
-    withdrawHelper(amount, "withdrawal");
+std::size_t HighInterestCheckingAccount::apply(std::span<const Transaction> batch) {
+    return applyBatch(*this, timeManager_.getDate(), batch);
+}
+
+bool HighInterestCheckingAccount::transferOut(Money amount, int to) {
+    return transferOutOn(*this, timeManager_.getDate(), amount, to);
 }
 
-void HighInterestCheckingAccount::withdrawHelper(Money amount, std::string_view action) {
-    std::string statementInfo{};
-    bool success{};
+void HighInterestCheckingAccount::transferIn(Money amount, int from) {
+    transferIntoOn(*this, timeManager_.getDate(), amount, from);
+}
+
+void HighInterestCheckingAccount::depositOn(Date when, Money amount) {
+    balance_ += amount;
+
+    addToMonthlyStatement(when, {
+                                    .event = StatementRecordInfo::Event::Deposit,
+                                    .balanceChange = amount,
+                                    .changeType = StatementRecordInfo::Increase,
+                                    .resultantBalance = getBalance(),
+                                });
+    timeManager_.reschedule(getNextEventDate());
+}
+
+void HighInterestCheckingAccount::writeCheckOn(Date when, Money amount) {
+    withdrawHelper(when, amount, StatementRecordInfo::Event::Check);
+}
+
+void HighInterestCheckingAccount::withdrawOn(Date when, Money amount) {
+    withdrawHelper(when, amount, StatementRecordInfo::Event::Withdrawal);
+}
+
+void HighInterestCheckingAccount::withdrawHelper(Date when, Money amount, StatementRecordInfo::Event action) {
+    auto outcome = StatementRecordInfo::Outcome::Success;
 
     if (balance_ <= MIN_BALANCE) {
-        statementInfo = fmt::format("{} failure ({}). Account balance already at or below minimum of {}.", action,
-                                    amount, MIN_BALANCE);
-        success = false;
+        outcome = StatementRecordInfo::Outcome::ActionAtMinimumBalance;
     } else if (amount <= balance_ - MIN_BALANCE) {
-        statementInfo = fmt::format("Successful {}", action);
         balance_ -= amount;
-        success = true;
     } else {
-        statementInfo =
-            fmt::format("{} failure ({}). Would place account below minimum of {}.", action, amount, MIN_BALANCE);
-        success = false;
+        outcome = StatementRecordInfo::Outcome::ActionBelowMinimumBalance;
     }
 
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = statementInfo,
-                                                      .balanceChange = success ? amount : 0_dollars,
-                                                      .changeType = StatementRecordInfo::Decrease,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+    const bool success = outcome == StatementRecordInfo::Outcome::Success;
+    addToMonthlyStatement(when, {
+                                    .event = action,
+                                    .outcome = outcome,
+                                    .amount = amount,
+                                    .minBalance = MIN_BALANCE,
+                                    .balanceChange = success ? amount : 0_dollars,
+                                    .changeType = StatementRecordInfo::Decrease,
+                                    .resultantBalance = getBalance(),
+                                });
+    // Dropping below the minimum balance is recorded on every update
+    timeManager_.reschedule(getNextEventDate());
 }
 
 void HighInterestCheckingAccount::update(DatePeriod period) {
@@ -68,22 +113,37 @@ void HighInterestCheckingAccount::update(DatePeriod period) {
     if (balance_ < MIN_BALANCE) {
         addToMonthlyStatement(timeManager_.getDate(),
                               {
-                                  .details = "Failed to earn interest as account balance is below minimum requirement",
+                                  .event = StatementRecordInfo::Event::Interest,
+                                  .outcome = StatementRecordInfo::Outcome::AtMinimumBalance,
+                                  .minBalance = MIN_BALANCE,
                                   .balanceChange = 0_dollars,
                                   .changeType = StatementRecordInfo::Increase,
                                   .resultantBalance = getBalance(),
                               });
+        timeManager_.reschedule(getNextEventDate());
         return;
     }
 
-    interestHandler_.processDuring(period.begin, period.end, [&](Date when, double rate) {
-        auto interestAmount = getBalance() * rate * INTEREST_MULTIPLIER;
+    interestHandler_.processDuring(period.begin, period.end, [&](Date when, Rate rate) {
+        auto interestAmount = getBalance() * (rate * INTEREST_MULTIPLIER);
         balance_ += interestAmount;
         addToMonthlyStatement(when, {
-                                        .details = fmt::format("Accumulated interest at {:.2f}%", rate * 100),
+                                        .event = StatementRecordInfo::Event::Interest,
+                                        .rate = rate,
                                         .balanceChange = interestAmount,
                                         .changeType = StatementRecordInfo::Increase,
                                         .resultantBalance = getBalance(),
                                     });
     });
+
+    timeManager_.reschedule(getNextEventDate());
+}
+
+Date HighInterestCheckingAccount::getNextEventDate() const {
+    // A record is made on every update while below the minimum balance
+    if (balance_ < MIN_BALANCE) {
+        return timeManager_.getDate();
+    }
+
+    return std::min(interestHandler_.getNextPayoutDate(), getNextStatementDate());
 }
@@ -3,11 +3,21 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <utility>
+
 HighInterestSavingsAccount::HighInterestSavingsAccount(const HighInterestSavingsAccount& other)
     : AccountInfo(other)
     , interestHandler_{other.interestHandler_}
     , timeManager_(other.timeManager_.clone([this](DatePeriod period) { update(period); })) {}
 
+HighInterestSavingsAccount::HighInterestSavingsAccount(HighInterestSavingsAccount&& other) noexcept
+    : AccountInfo(std::move(other))
+    , interestHandler_{other.interestHandler_}
+    , timeManager_(std::move(other.timeManager_), [this](DatePeriod period) { update(period); }) {}
+
 HighInterestSavingsAccount& HighInterestSavingsAccount::operator=(const HighInterestSavingsAccount& rhs) {
     if (&rhs == this) {
         return *this;
@@ -18,59 +28,101 @@ HighInterestSavingsAccount& HighInterestSavingsAccount::operator=(const HighInte
     return *this;
 }
 
+HighInterestSavingsAccount& HighInterestSavingsAccount::operator=(HighInterestSavingsAccount&& rhs) noexcept {
+    if (&rhs == this) {
+        return *this;
+    }
+
+    AccountInfo::operator=(std::move(rhs));
+    interestHandler_ = rhs.interestHandler_;
+    timeManager_ = TimeManagerResource{std::move(rhs.timeManager_), [this](DatePeriod period) { update(period); }};
+    return *this;
+}
+
 void HighInterestSavingsAccount::deposit(Money amount) {
+    depositOn(timeManager_.getDate(), amount);
+}
+
+void HighInterestSavingsAccount::withdraw(Money amount) {
+    withdrawOn(timeManager_.getDate(), amount);
+}
+
+std::size_t HighInterestSavingsAccount::apply(std::span<const Transaction> batch) {
+    return applyBatch(*this, timeManager_.getDate(), batch);
+}
+
+bool HighInterestSavingsAccount::transferOut(Money amount, int to) {
+    return transferOutOn(*this, timeManager_.getDate(), amount, to);
+}
+
+void HighInterestSavingsAccount::transferIn(Money amount, int from) {
+    transferIntoOn(*this, timeManager_.getDate(), amount, from);
+}
+
+void HighInterestSavingsAccount::depositOn(Date when, Money amount) {
     balance_ += amount;
 
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = "Successful deposit",
-                                                      .balanceChange = amount,
-                                                      .changeType = StatementRecordInfo::Increase,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+    addToMonthlyStatement(when, {
+                                    .event = StatementRecordInfo::Event::Deposit,
+                                    .balanceChange = amount,
+                                    .changeType = StatementRecordInfo::Increase,
+                                    .resultantBalance = getBalance(),
+                                });
+    // Interest may start being earned again
+    timeManager_.reschedule(getNextEventDate());
 }
 
-void HighInterestSavingsAccount::withdraw(Money amount) {
-    std::string statementInfo{};
-    bool success{};
+void HighInterestSavingsAccount::withdrawOn(Date when, Money amount) {
+    auto outcome = StatementRecordInfo::Outcome::Success;
 
     if (balance_ <= MIN_BALANCE) {
-        statementInfo = fmt::format("Failed to withdraw {}. Account balance already at or below minimum of {}.", amount,
-                                    MIN_BALANCE);
-        success = false;
+        outcome = StatementRecordInfo::Outcome::AtMinimumBalance;
     } else if (amount <= balance_ - MIN_BALANCE) {
-        statementInfo = fmt::format("Successful withdrawal");
         balance_ -= amount;
-        success = true;
     } else {
-        statementInfo =
-            fmt::format("Failed to withdraw {}. Would place account below minimum of {}.", amount, MIN_BALANCE);
-        success = false;
+        outcome = StatementRecordInfo::Outcome::BelowMinimumBalance;
     }
 
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = statementInfo,
-                                                      .balanceChange = success ? amount : 0_dollars,
-                                                      .changeType = StatementRecordInfo::Decrease,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+    const bool success = outcome == StatementRecordInfo::Outcome::Success;
+    addToMonthlyStatement(when, {
+                                    .event = StatementRecordInfo::Event::Withdrawal,
+                                    .outcome = outcome,
+                                    .amount = amount,
+                                    .minBalance = MIN_BALANCE,
+                                    .balanceChange = success ? amount : 0_dollars,
+                                    .changeType = StatementRecordInfo::Decrease,
+                                    .resultantBalance = getBalance(),
+                                });
 }
 
 void HighInterestSavingsAccount::update(DatePeriod period) {
     addStatementsThrough(period.end);
     // Do not earn any interest if balance is below minumum
     if (balance_ < MIN_BALANCE) {
+        timeManager_.reschedule(getNextEventDate());
         return;
     }
 
     // It would be much cleaner to just reuse `SavingsAccount::update` here
-    interestHandler_.processDuring(period.begin, period.end, [&](Date when, double rate) {
+    interestHandler_.processDuring(period.begin, period.end, [&](Date when, Rate rate) {
         auto interestAmount = getBalance() * rate;
         balance_ += interestAmount;
         addToMonthlyStatement(when, {
-                                        .details = fmt::format("Accumulated interest at {:.2f}%", rate * 100),
+                                        .event = StatementRecordInfo::Event::Interest,
+                                        .rate = rate,
                                         .balanceChange = interestAmount,
                                         .changeType = StatementRecordInfo::Increase,
                                         .resultantBalance = getBalance(),
                                     });
     });
+
+    timeManager_.reschedule(getNextEventDate());
+}
+
+Date HighInterestSavingsAccount::getNextEventDate() const {
+    if (balance_ < MIN_BALANCE) {
+        return getNextStatementDate();
+    }
+
+    return std::min(interestHandler_.getNextPayoutDate(), getNextStatementDate());
 }
@@ -1,57 +1,53 @@
 #include "interest_handler.h"
 
+#include <algorithm>
 #include <chrono>
 #include <ratio>
 
-InterestHandler::InterestHandler(InterestType compoundingPeriod, double rate)
+InterestHandler::InterestHandler(InterestType compoundingPeriod, Rate rate)
     : compoundingPeriod_{compoundingPeriod}
     , rate_{rate} {}
 
-void InterestHandler::processDuring(Date begin, Date end, const std::function<void(Date, double)>& interestPayoutFn) {
-    if (!lastPayment_.get().ok()) {
+void InterestHandler::processDuring(Date begin, Date end, const std::function<void(Date, Rate)>& interestPayoutFn) {
+    if (!lastPayment_.ok()) {
         lastPayment_ = begin;
     }
 
-    for (std::chrono::sys_days day = begin.get(); day <= end.get(); day += std::chrono::days{1}) {
-        tryProcessOn(Date{day}, interestPayoutFn);
+    // Payouts land exactly one period apart, so they can be stepped through directly rather than checking every day.
+    // The first one is either a full period after the last payout, or at `begin` if that has already passed.
+    const auto period = getPeriodLength();
+
+    for (auto day = std::max(begin, lastPayment_ + period); day <= end; day = day + period) {
+        lastPayment_ = day;
+        interestPayoutFn(day, rate_);
     }
 }
 
-void InterestHandler::tryProcessOn(Date day, const std::function<void(Date, double)>& interestPayoutFn) {
+Date InterestHandler::getNextPayoutDate() const {
+    if (!lastPayment_.ok()) {
+        return Date{};
+    }
+
+    return lastPayment_ + getPeriodLength();
+}
+
+std::chrono::days InterestHandler::getPeriodLength() const {
     using enum InterestType;
+    using QuarterlyT = std::chrono::duration<int, std::ratio_multiply<std::ratio<3>, std::chrono::months::period>>;
 
+    // Periods are the average gregorian lengths used by `Date::diff`, so a payout is due on the first whole day which
+    // is at least that far past the previous one.
     switch (compoundingPeriod_) {
     case Daily:
-        if (Date::diff<std::chrono::days>(lastPayment_, day) > 0) {
-            lastPayment_ = day;
-            interestPayoutFn(day, rate_);
-            break;
-        }
-        return;
-
+        return std::chrono::days{1};
     case Monthly:
-        if (Date::diff<std::chrono::months>(lastPayment_, day) > 0) {
-            lastPayment_ = day;
-            interestPayoutFn(day, rate_);
-            break;
-        }
-        return;
-
+        return std::chrono::ceil<std::chrono::days>(std::chrono::months{1});
     case Quarterly:
-        using QuarterlyT = std::chrono::duration<int, std::ratio_multiply<std::ratio<3>, std::chrono::months::period>>;
-        if (Date::diff<QuarterlyT>(lastPayment_, day) > 0) {
-            lastPayment_ = day;
-            interestPayoutFn(day, rate_);
-            break;
-        }
-        return;
-
+        return std::chrono::ceil<std::chrono::days>(QuarterlyT{1});
     case Yearly:
-        if (Date::diff<std::chrono::years>(lastPayment_, day) > 0) {
-            lastPayment_ = day;
-            interestPayoutFn(day, rate_);
-            break;
-        }
-        return;
+        return std::chrono::ceil<std::chrono::days>(std::chrono::years{1});
     }
+
+    util::ctassert(false, "Unhandled compounding period");
+    return {};
 }
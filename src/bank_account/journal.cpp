@@ -0,0 +1,406 @@
+#include "journal.h"
+#include "snapshot.h"
+#include "util/date_util.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+static_assert(std::endian::native == std::endian::little, "Journals share the byte order of snapshots");
+
+/*
+  File layout, version 1:
+
+    FileHeader
+    for each record: RecordHeader, then its payload padded to 8 bytes
+
+  Only opening an account has a payload, which is the account encoded as in a snapshot.
+*/
+
+namespace {
+
+// The first three match Transaction::Type
+enum class RecordType : std::uint8_t { Deposit, Withdrawal, Check, TimeStep, Opened, Closed };
+
+constexpr std::array<char, 8> MAGIC{'B', 'A', 'N', 'K', 'J', 'R', 'N', 'L'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::size_t ALIGNMENT = 8;
+
+struct FileHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t recordHeaderSize;
+};
+
+struct RecordHeader
+{
+    // Covers the rest of the header and the payload
+    std::uint32_t checksum;
+    std::uint8_t type;
+    std::array<std::uint8_t, 3> padding;
+    std::uint64_t sequence;
+    std::int32_t number;
+    std::uint32_t payloadSize;
+    // Cents for transactions, days for time steps
+    std::uint64_t value;
+};
+
+static_assert(sizeof(FileHeader) == 16 && sizeof(RecordHeader) == 32);
+
+std::size_t padded(std::size_t size) {
+    return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+// FNV-1a, which is plenty to catch a torn write
+std::uint32_t checksum(const RecordHeader& header, std::span<const std::byte> payload) {
+    std::uint32_t hash = 2166136261U;
+    auto add = [&](std::span<const std::byte> bytes) {
+        for (const auto byte : bytes) {
+            hash = (hash ^ std::to_integer<std::uint32_t>(byte)) * 16777619U;
+        }
+    };
+    add(std::as_bytes(std::span{&header, 1}).subspan(sizeof(header.checksum)));
+    add(payload);
+    return hash;
+}
+
+//! Reads the records of a journal file in order, stopping at the first which is incomplete or damaged
+class RecordReader
+{
+public:
+    explicit RecordReader(const std::filesystem::path& path)
+        : file_{path, std::ios::binary} {
+        FileHeader header{};
+        if (!read(&header, sizeof(header)) || header.magic != MAGIC ||
+            header.recordHeaderSize != sizeof(RecordHeader)) {
+            throw std::runtime_error(path.string() + " is not a journal");
+        }
+        if (header.version != VERSION) {
+            throw std::runtime_error("Unsupported journal version " + std::to_string(header.version));
+        }
+        intactSize_ = sizeof(FileHeader);
+    }
+
+    //! Returns false once there are no more intact records
+    bool next(RecordHeader& header, std::vector<std::byte>& payload) {
+        if (!read(&header, sizeof(header)) || header.sequence <= lastSequence_) {
+            return false;
+        }
+        payload.resize(padded(header.payloadSize));
+        if (!read(payload.data(), payload.size())) {
+            return false;
+        }
+        payload.resize(header.payloadSize);
+        if (header.checksum != checksum(header, payload) ||
+            header.type > static_cast<std::uint8_t>(RecordType::Closed)) {
+            return false;
+        }
+
+        lastSequence_ = header.sequence;
+        intactSize_ += sizeof(RecordHeader) + padded(header.payloadSize);
+        return true;
+    }
+
+    std::uint64_t lastSequence() const { return lastSequence_; }
+    //! Size of the header and the records read so far
+    std::uint64_t intactSize() const { return intactSize_; }
+
+private:
+    bool read(void* out, std::size_t count) {
+        file_.read(static_cast<char*>(out), static_cast<std::streamsize>(count));
+        return static_cast<bool>(file_);
+    }
+
+    std::ifstream file_;
+    std::uint64_t lastSequence_ = 0;
+    std::uint64_t intactSize_ = 0;
+};
+
+template <typename T>
+void appendBytes(std::vector<std::byte>& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto bytes = std::as_bytes(std::span{&value, 1});
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+BankAccount& openAccount(AccountStore<BankAccount>& accounts, int number) {
+    auto* account = accounts.find(number);
+    if (account == nullptr) {
+        throw std::runtime_error("Journal refers to account " + std::to_string(number) + ", which is not open");
+    }
+    return *account;
+}
+
+} // namespace
+
+Journal::Journal(const std::filesystem::path& path)
+    : Journal(path, Options{}) {}
+
+Journal::Journal(const std::filesystem::path& path, Options options)
+    : path_{path}
+    , options_{options} {
+    // Reading an existing journal first, so nothing is changed if it turns out not to be one
+    std::uint64_t existingSize = 0;
+    if (std::filesystem::exists(path_)) {
+        existingSize = std::filesystem::file_size(path_);
+    }
+    std::uint64_t intactSize = 0;
+    if (existingSize >= sizeof(FileHeader)) {
+        RecordReader reader{path_};
+        RecordHeader header{};
+        std::vector<std::byte> payload;
+        while (reader.next(header, payload)) {
+        }
+        lastSequence_ = reader.lastSequence();
+        intactSize = reader.intactSize();
+    }
+
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644); // NOLINT(*vararg)
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to open journal " + path_.string());
+    }
+
+    try {
+        if (intactSize == 0) {
+            // New, or a crash cut off writing the header
+            std::vector<std::byte> header;
+            appendBytes(header,
+                        FileHeader{.magic = MAGIC, .version = VERSION, .recordHeaderSize = sizeof(RecordHeader)});
+            writeOut(header, 0);
+            intactSize = header.size();
+        }
+        if (intactSize < existingSize && ::ftruncate(fd_, static_cast<off_t>(intactSize)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to truncate journal " + path_.string());
+        }
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+
+    fileSize_ = intactSize;
+    durableSequence_ = lastSequence_;
+    active_.reserve(options_.bufferSize);
+    flushing_.reserve(options_.bufferSize);
+    flusher_ = std::thread{[this] { flusherLoop(); }};
+}
+
+Journal::~Journal() {
+    {
+        const std::lock_guard lock{mutex_};
+        stopping_ = true;
+    }
+    flushNeeded_.notify_one();
+    flusher_.join();
+    ::close(fd_);
+}
+
+std::size_t Journal::replay(AccountStore<BankAccount>& accounts, std::uint64_t afterSequence) {
+    {
+        // A snapshot may be newer than an emptied journal, and later records must still be numbered after it
+        const std::lock_guard lock{mutex_};
+        lastSequence_ = std::max(lastSequence_, afterSequence);
+        durableSequence_ = std::max(durableSequence_, afterSequence);
+    }
+
+    RecordReader reader{path_};
+    RecordHeader header{};
+    std::vector<std::byte> payload;
+    std::size_t numApplied = 0;
+    while (reader.next(header, payload)) {
+        if (header.sequence <= afterSequence) {
+            continue;
+        }
+
+        using enum RecordType;
+        switch (static_cast<RecordType>(header.type)) {
+        case Deposit:
+        case Withdrawal:
+        case Check: {
+            const Transaction transaction{.type = static_cast<Transaction::Type>(header.type),
+                                          .amount = Money::fromCents(header.value)};
+            openAccount(accounts, header.number).apply(std::span{&transaction, 1});
+            break;
+        }
+        case TimeStep:
+            SimTimeManager::incrDay(std::chrono::days{static_cast<std::chrono::days::rep>(header.value)});
+            SimTimeManager::updateAll();
+            break;
+        case Opened:
+            accounts.insert(decodeAccount(payload));
+            break;
+        case Closed:
+            openAccount(accounts, header.number);
+            accounts.close(header.number);
+            break;
+        }
+        ++numApplied;
+    }
+    return numApplied;
+}
+
+void Journal::record(int number, const Transaction& transaction) {
+    static_assert(static_cast<int>(Transaction::Type::Deposit) == static_cast<int>(RecordType::Deposit) &&
+                  static_cast<int>(Transaction::Type::Withdrawal) == static_cast<int>(RecordType::Withdrawal) &&
+                  static_cast<int>(Transaction::Type::Check) == static_cast<int>(RecordType::Check));
+    append(static_cast<std::uint8_t>(transaction.type), number, transaction.amount.totalCents());
+}
+
+void Journal::recordTimeStep(std::chrono::days days) {
+    append(static_cast<std::uint8_t>(RecordType::TimeStep), 0, static_cast<std::uint64_t>(days.count()));
+}
+
+void Journal::recordOpened(const BankAccount& account) {
+    append(static_cast<std::uint8_t>(RecordType::Opened), account.getAccountNumber(), 0, encodeAccount(account));
+}
+
+void Journal::recordClosed(int number) {
+    append(static_cast<std::uint8_t>(RecordType::Closed), number, 0);
+}
+
+std::uint64_t Journal::lastSequence() const {
+    const std::lock_guard lock{mutex_};
+    return lastSequence_;
+}
+
+void Journal::sync() {
+    std::unique_lock lock{mutex_};
+    waitForFlush(lock);
+}
+
+bool Journal::checkpoint(std::uint64_t snapshotSequence) {
+    std::unique_lock lock{mutex_};
+    if (lastSequence_ != snapshotSequence) {
+        return false;
+    }
+    waitForFlush(lock);
+    // Checked again as the lock was released while waiting, but from here on nothing can be recorded
+    if (lastSequence_ != snapshotSequence) {
+        return false;
+    }
+
+    if (::ftruncate(fd_, sizeof(FileHeader)) != 0 || ::fdatasync(fd_) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to empty journal " + path_.string());
+    }
+    fileSize_ = sizeof(FileHeader);
+    return true;
+}
+
+void Journal::append(std::uint8_t type, int number, std::uint64_t value, std::span<const std::byte> payload) {
+    const auto recordSize = sizeof(RecordHeader) + padded(payload.size());
+
+    std::unique_lock lock{mutex_};
+    // A record bigger than a whole buffer goes into an empty one, which grows to fit it
+    if (!active_.empty() && active_.size() + recordSize > options_.bufferSize) {
+        ++numWaiting_;
+        flushNeeded_.notify_one();
+        flushed_.wait(lock, [&] {
+            return active_.empty() || active_.size() + recordSize <= options_.bufferSize || !error_.empty();
+        });
+        --numWaiting_;
+    }
+    throwIfFailed();
+
+    if (active_.empty()) {
+        batchStart_ = std::chrono::steady_clock::now();
+        flushNeeded_.notify_one();
+    }
+
+    RecordHeader header{
+        .checksum = 0,
+        .type = type,
+        .padding = {},
+        .sequence = ++lastSequence_,
+        .number = number,
+        .payloadSize = static_cast<std::uint32_t>(payload.size()),
+        .value = value,
+    };
+    header.checksum = checksum(header, payload);
+    appendBytes(active_, header);
+    active_.insert(active_.end(), payload.begin(), payload.end());
+    active_.resize(active_.size() + padded(payload.size()) - payload.size());
+}
+
+void Journal::waitForFlush(std::unique_lock<std::mutex>& lock) {
+    const auto target = lastSequence_;
+    ++numWaiting_;
+    flushNeeded_.notify_one();
+    flushed_.wait(lock, [&] { return durableSequence_ >= target || !error_.empty(); });
+    --numWaiting_;
+    throwIfFailed();
+}
+
+void Journal::throwIfFailed() const {
+    if (!error_.empty()) {
+        throw std::runtime_error("Failed to write journal: " + error_);
+    }
+}
+
+void Journal::flusherLoop() {
+    std::unique_lock lock{mutex_};
+    for (;;) {
+        flushNeeded_.wait(lock, [&] { return stopping_ || !active_.empty(); });
+        if (active_.empty()) {
+            return;
+        }
+
+        // Let more records join the batch, unless someone is waiting for it or the buffer is filling up
+        flushNeeded_.wait_until(lock, batchStart_ + options_.maxDelay, [&] {
+            return stopping_ || numWaiting_ > 0 || active_.size() >= options_.bufferSize / 2;
+        });
+
+        std::swap(active_, flushing_);
+        const auto through = lastSequence_;
+        const auto offset = fileSize_;
+        fileSize_ += flushing_.size();
+        // Recording can carry on into the emptied buffer while this one is written
+        flushed_.notify_all();
+        lock.unlock();
+
+        std::string error;
+        try {
+            writeOut(flushing_, offset);
+        } catch (const std::exception& failure) {
+            error = failure.what();
+        }
+        flushing_.clear();
+
+        lock.lock();
+        if (error.empty()) {
+            durableSequence_ = through;
+        } else if (error_.empty()) {
+            error_ = std::move(error);
+        }
+        flushed_.notify_all();
+    }
+}
+
+void Journal::writeOut(const std::vector<std::byte>& bytes, std::uint64_t offset) const {
+    std::size_t written = 0;
+    while (written < bytes.size()) {
+        const auto result = ::pwrite(fd_, bytes.data() + written, bytes.size() - written,
+                                     static_cast<off_t>(offset + written));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to write journal " + path_.string());
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    if (::fdatasync(fd_) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to sync journal " + path_.string());
+    }
+}
@@ -0,0 +1,131 @@
+#include "money_type.h"
+
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+namespace {
+
+constexpr std::uint64_t MAX_CENTS = std::numeric_limits<std::uint64_t>::max();
+constexpr std::uint64_t MAX_DOLLARS = MAX_CENTS / 100;
+
+// Eight characters are loaded as one word, which is only laid out first character first on little-endian machines
+constexpr bool SWAR_DIGITS = std::endian::native == std::endian::little;
+
+bool isDigit(char chr) {
+    return chr >= '0' && chr <= '9';
+}
+
+//! Whether each of the eight characters in `chunk` is a digit
+bool allDigits(std::uint64_t chunk) {
+    // Digits are 0x30 to 0x39, so their high nibble is 3 and stays 3 after adding 6 to the low one
+    return (((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+            0x3333333333333333);
+}
+
+//! Value of the eight digits in `chunk`, combining neighbouring pairs, then quads, then the two halves
+std::uint64_t parseEightDigits(std::uint64_t chunk) {
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10 + (chunk >> 8)) & 0x00FF00FF00FF00FF;
+    chunk = (chunk * 100 + (chunk >> 16)) & 0x0000FFFF0000FFFF;
+    return (chunk * 10'000 + (chunk >> 32)) & 0xFFFFFFFF;
+}
+
+/*!
+  Appends the run of digits at `iter` to `value`, returning the end of the run, or nullptr if `value` would pass `max`.
+  `numDigits` is increased by the length of the run.
+*/
+const char* parseDigits(const char* iter, const char* end, std::uint64_t& value, std::uint64_t max,
+                        std::size_t& numDigits) {
+    constexpr std::uint64_t CHUNK_SCALE = 100'000'000;
+
+    if constexpr (SWAR_DIGITS) {
+        while (end - iter >= 8) {
+            std::uint64_t chunk = 0;
+            std::memcpy(&chunk, iter, sizeof(chunk));
+            if (!allDigits(chunk)) {
+                break;
+            }
+            const auto digits = parseEightDigits(chunk);
+            if (value > (max - digits) / CHUNK_SCALE) {
+                return nullptr;
+            }
+            value = value * CHUNK_SCALE + digits;
+            iter += 8; // NOLINT(*pointer-arithmetic)
+            numDigits += 8;
+        }
+    }
+
+    for (; iter != end && isDigit(*iter); ++iter) { // NOLINT(*pointer-arithmetic)
+        const auto digit = static_cast<std::uint64_t>(*iter - '0');
+        if (value > (max - digit) / 10) {
+            return nullptr;
+        }
+        value = value * 10 + digit;
+        ++numDigits;
+    }
+    return iter;
+}
+
+//! Whether `iter` is at a comma followed by exactly three digits
+bool isGroup(const char* iter, const char* end) {
+    // NOLINTBEGIN(*pointer-arithmetic)
+    return end - iter >= 4 && iter[0] == ',' && isDigit(iter[1]) && isDigit(iter[2]) && isDigit(iter[3]) &&
+           (end - iter == 4 || !isDigit(iter[4]));
+    // NOLINTEND(*pointer-arithmetic)
+}
+
+} // namespace
+
+// NOLINTBEGIN(*pointer-arithmetic)
+std::from_chars_result parseMoney(std::string_view text, Money& value) {
+    const char* iter = text.data();
+    const char* const end = text.data() + text.size();
+
+    if (iter != end && *iter == '$') {
+        ++iter;
+    }
+    if (iter == end || !isDigit(*iter)) {
+        return {text.data(), std::errc::invalid_argument};
+    }
+
+    std::uint64_t dollars = 0;
+    std::size_t numDigits = 0;
+    iter = parseDigits(iter, end, dollars, MAX_DOLLARS, numDigits);
+    if (iter == nullptr) {
+        return {text.data(), std::errc::result_out_of_range};
+    }
+
+    // Commas may only follow a leading group of at most three digits
+    if (numDigits <= 3) {
+        for (; isGroup(iter, end); iter += 4) {
+            const auto group =
+                static_cast<std::uint64_t>((iter[1] - '0') * 100 + (iter[2] - '0') * 10 + (iter[3] - '0'));
+            if (dollars > (MAX_DOLLARS - group) / 1000) {
+                return {text.data(), std::errc::result_out_of_range};
+            }
+            dollars = dollars * 1000 + group;
+        }
+    }
+
+    std::uint64_t cents = 0;
+    if (iter != end && *iter == '.') {
+        ++iter;
+        if (iter != end && isDigit(*iter)) {
+            cents = static_cast<std::uint64_t>(*iter - '0') * 10;
+            ++iter;
+            if (iter != end && isDigit(*iter)) {
+                cents += static_cast<std::uint64_t>(*iter - '0');
+                ++iter;
+            }
+        }
+    }
+
+    if (dollars > (MAX_CENTS - cents) / 100) {
+        return {text.data(), std::errc::result_out_of_range};
+    }
+    value = Money::fromCents(dollars * 100 + cents);
+    return {iter, std::errc{}};
+}
+// NOLINTEND(*pointer-arithmetic)
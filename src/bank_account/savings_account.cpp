@@ -1,11 +1,21 @@
 #include "savings_account.h"
 #include "util/date_util.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <utility>
+
 SavingsAccount::SavingsAccount(const SavingsAccount& other)
     : AccountInfo(other)
     , interestHandler_{other.interestHandler_}
     , timeManager_(other.timeManager_.clone([this](DatePeriod period) { update(period); })) {}
 
+SavingsAccount::SavingsAccount(SavingsAccount&& other) noexcept
+    : AccountInfo(std::move(other))
+    , interestHandler_{other.interestHandler_}
+    , timeManager_(std::move(other.timeManager_), [this](DatePeriod period) { update(period); }) {}
+
 SavingsAccount& SavingsAccount::operator=(const SavingsAccount& rhs) {
     if (&rhs == this) {
         return *this;
@@ -16,47 +26,84 @@ SavingsAccount& SavingsAccount::operator=(const SavingsAccount& rhs) {
     return *this;
 }
 
-void SavingsAccount::deposit(Money amount) {
-    balance_ += amount;
+SavingsAccount& SavingsAccount::operator=(SavingsAccount&& rhs) noexcept {
+    if (&rhs == this) {
+        return *this;
+    }
+
+    AccountInfo::operator=(std::move(rhs));
+    interestHandler_ = rhs.interestHandler_;
+    timeManager_ = TimeManagerResource{std::move(rhs.timeManager_), [this](DatePeriod period) { update(period); }};
+    return *this;
+}
 
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = "Successful deposit",
-                                                      .balanceChange = amount,
-                                                      .changeType = StatementRecordInfo::Increase,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+void SavingsAccount::deposit(Money amount) {
+    depositOn(timeManager_.getDate(), amount);
 }
 
 void SavingsAccount::withdraw(Money amount) {
-    std::string statementInfo{};
+    withdrawOn(timeManager_.getDate(), amount);
+}
 
+std::size_t SavingsAccount::apply(std::span<const Transaction> batch) {
+    return applyBatch(*this, timeManager_.getDate(), batch);
+}
+
+bool SavingsAccount::transferOut(Money amount, int to) {
+    return transferOutOn(*this, timeManager_.getDate(), amount, to);
+}
+
+void SavingsAccount::transferIn(Money amount, int from) {
+    transferIntoOn(*this, timeManager_.getDate(), amount, from);
+}
+
+void SavingsAccount::depositOn(Date when, Money amount) {
+    balance_ += amount;
+
+    addToMonthlyStatement(when, {
+                                    .event = StatementRecordInfo::Event::Deposit,
+                                    .balanceChange = amount,
+                                    .changeType = StatementRecordInfo::Increase,
+                                    .resultantBalance = getBalance(),
+                                });
+}
+
+void SavingsAccount::withdrawOn(Date when, Money amount) {
     bool canWithdraw = amount <= balance_;
+    auto outcome = StatementRecordInfo::Outcome::InsufficientFunds;
 
     if (canWithdraw) {
         balance_ += amount;
-        statementInfo = fmt::format("Successful withdrawal");
-    } else {
-        statementInfo = fmt::format("Failed to withdraw {}", amount);
+        outcome = StatementRecordInfo::Outcome::Success;
     }
 
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = statementInfo,
-                                                      .balanceChange = canWithdraw ? amount : 0_dollars,
-                                                      .changeType = StatementRecordInfo::Decrease,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+    addToMonthlyStatement(when, {
+                                    .event = StatementRecordInfo::Event::Withdrawal,
+                                    .outcome = outcome,
+                                    .amount = amount,
+                                    .balanceChange = canWithdraw ? amount : 0_dollars,
+                                    .changeType = StatementRecordInfo::Decrease,
+                                    .resultantBalance = getBalance(),
+                                });
 }
 
 void SavingsAccount::update(DatePeriod period) {
     addStatementsThrough(period.end);
-    interestHandler_.processDuring(period.begin, period.end, [&](Date when, double rate) {
+    interestHandler_.processDuring(period.begin, period.end, [&](Date when, Rate rate) {
         auto interestAmount = getBalance() * rate;
         balance_ += interestAmount;
         addToMonthlyStatement(when, {
-                                        .details = fmt::format("Accumulated interest at {:.2f}%", rate * 100),
+                                        .event = StatementRecordInfo::Event::Interest,
+                                        .rate = rate,
                                         .balanceChange = interestAmount,
                                         .changeType = StatementRecordInfo::Increase,
                                         .resultantBalance = getBalance(),
                                     });
     });
+
+    timeManager_.reschedule(getNextEventDate());
+}
+
+Date SavingsAccount::getNextEventDate() const {
+    return std::min(interestHandler_.getNextPayoutDate(), getNextStatementDate());
 }
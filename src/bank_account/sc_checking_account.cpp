@@ -2,13 +2,24 @@
 
 #include <fmt/core.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstddef>
+#include <span>
 #include <string>
 #include <utility>
 
 ServiceChargeCheckingAccount::ServiceChargeCheckingAccount(const ServiceChargeCheckingAccount& other)
     : AccountInfo(other)
-    , timeManager_(other.timeManager_.clone([this](DatePeriod period) { update(period); })) {}
+    , remainingChecks_{other.remainingChecks_}
+    , timeManager_(other.timeManager_.clone([this](DatePeriod period) { update(period); }))
+    , lastServiceCharge_{other.lastServiceCharge_} {}
+
+ServiceChargeCheckingAccount::ServiceChargeCheckingAccount(ServiceChargeCheckingAccount&& other) noexcept
+    : AccountInfo(std::move(other))
+    , remainingChecks_{other.remainingChecks_}
+    , timeManager_(std::move(other.timeManager_), [this](DatePeriod period) { update(period); })
+    , lastServiceCharge_{other.lastServiceCharge_} {}
 
 ServiceChargeCheckingAccount& ServiceChargeCheckingAccount::operator=(const ServiceChargeCheckingAccount& rhs) {
     if (&rhs == this) {
@@ -20,88 +31,130 @@ ServiceChargeCheckingAccount& ServiceChargeCheckingAccount::operator=(const Serv
     return *this;
 }
 
-void ServiceChargeCheckingAccount::deposit(Money amt) {
-    balance_ += amt;
+ServiceChargeCheckingAccount& ServiceChargeCheckingAccount::operator=(ServiceChargeCheckingAccount&& rhs) noexcept {
+    if (&rhs == this) {
+        return *this;
+    }
 
-    const std::string statementInfo = fmt::format("Successful deposit", amt);
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = statementInfo,
-                                                      .balanceChange = amt,
-                                                      .changeType = StatementRecordInfo::Increase,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+    AccountInfo::operator=(std::move(rhs));
+    remainingChecks_ = rhs.remainingChecks_;
+    lastServiceCharge_ = rhs.lastServiceCharge_;
+    timeManager_ = TimeManagerResource{std::move(rhs.timeManager_), [this](DatePeriod period) { update(period); }};
+    return *this;
+}
+
+void ServiceChargeCheckingAccount::deposit(Money amt) {
+    depositOn(timeManager_.getDate(), amt);
 }
 
 void ServiceChargeCheckingAccount::withdraw(Money amt) {
-    std::string statementInfo{};
+    withdrawOn(timeManager_.getDate(), amt);
+}
 
+void ServiceChargeCheckingAccount::writeCheck(Money amount) {
+    writeCheckOn(timeManager_.getDate(), amount);
+}
+
+std::size_t ServiceChargeCheckingAccount::apply(std::span<const Transaction> batch) {
+    return applyBatch(*this, timeManager_.getDate(), batch);
+}
+
+bool ServiceChargeCheckingAccount::transferOut(Money amount, int to) {
+    return transferOutOn(*this, timeManager_.getDate(), amount, to);
+}
+
+void ServiceChargeCheckingAccount::transferIn(Money amount, int from) {
+    transferIntoOn(*this, timeManager_.getDate(), amount, from);
+}
+
+void ServiceChargeCheckingAccount::depositOn(Date when, Money amt) {
+    balance_ += amt;
+
+    addToMonthlyStatement(when, {
+                                    .event = StatementRecordInfo::Event::Deposit,
+                                    .balanceChange = amt,
+                                    .changeType = StatementRecordInfo::Increase,
+                                    .resultantBalance = getBalance(),
+                                });
+}
+
+void ServiceChargeCheckingAccount::withdrawOn(Date when, Money amt) {
     bool canWithdraw = amt <= getBalance();
+    auto outcome = StatementRecordInfo::Outcome::InsufficientFunds;
 
     if (canWithdraw) {
         balance_ -= amt;
-        statementInfo = fmt::format("Successful withdrawal");
-    } else {
-        statementInfo = fmt::format("Failed to withdraw {}", amt);
+        outcome = StatementRecordInfo::Outcome::Success;
     }
 
-    addToMonthlyStatement(timeManager_.getDate(), {
-                                                      .details = statementInfo,
-                                                      .balanceChange = canWithdraw ? amt : 0_dollars,
-                                                      .changeType = StatementRecordInfo::Decrease,
-                                                      .resultantBalance = getBalance(),
-                                                  });
+    addToMonthlyStatement(when, {
+                                    .event = StatementRecordInfo::Event::Withdrawal,
+                                    .outcome = outcome,
+                                    .amount = amt,
+                                    .balanceChange = canWithdraw ? amt : 0_dollars,
+                                    .changeType = StatementRecordInfo::Decrease,
+                                    .resultantBalance = getBalance(),
+                                });
 }
 
-void ServiceChargeCheckingAccount::writeCheck(Money amount) {
+void ServiceChargeCheckingAccount::writeCheckOn(Date when, Money amount) {
     if (remainingChecks_ <= 0) {
-        addToMonthlyStatement(
-            timeManager_.getDate(),
-            {
-                .details =
-                    fmt::format("Failed to write check for {}. Reached maximum allowable checks in one month.", amount),
-                .balanceChange = 0_dollars,
-                .changeType = StatementRecordInfo::Decrease,
-                .resultantBalance = getBalance(),
-            });
+        addToMonthlyStatement(when, {
+                                        .event = StatementRecordInfo::Event::Check,
+                                        .outcome = StatementRecordInfo::Outcome::CheckLimitReached,
+                                        .amount = amount,
+                                        .balanceChange = 0_dollars,
+                                        .changeType = StatementRecordInfo::Decrease,
+                                        .resultantBalance = getBalance(),
+                                    });
         return;
     }
 
     remainingChecks_--;
 
-    withdraw(amount);
+    withdrawOn(when, amount);
 }
 
 void ServiceChargeCheckingAccount::update(DatePeriod period) {
     addStatementsThrough(period.end);
-    if (!lastServiceCharge_.get().ok()) {
+    if (!lastServiceCharge_.ok()) {
         lastServiceCharge_ = period.begin;
     }
 
     while (Date::diff<std::chrono::months>(lastServiceCharge_, period.end) >= 1) {
-        auto dayToCharge = Date{lastServiceCharge_.get() + std::chrono::months{1}};
+        auto dayToCharge = lastServiceCharge_ + std::chrono::months{1};
         lastServiceCharge_ = dayToCharge;
         remainingChecks_ = CHECKS_PER_MONTH;
 
         Money amount;
-        std::string statementInfo;
+        auto outcome = StatementRecordInfo::Outcome::Success;
 
         if (getBalance() >= SERVICE_CHARGE) {
             amount = SERVICE_CHARGE;
-            statementInfo = "Service charge fee";
         } else if (getBalance() > 0_dollars) {
-            statementInfo = "Service charge fee. Account has run out of funds.";
+            outcome = StatementRecordInfo::Outcome::InsufficientFunds;
             amount = getBalance();
         } else {
-            statementInfo = "Attempted service charge fee, but account is empty.";
+            outcome = StatementRecordInfo::Outcome::NoFunds;
             amount = 0_dollars;
         }
 
         balance_ -= amount;
         addToMonthlyStatement(dayToCharge, {
-                                               .details = statementInfo,
+                                               .event = StatementRecordInfo::Event::ServiceCharge,
+                                               .outcome = outcome,
                                                .balanceChange = amount,
                                                .changeType = StatementRecordInfo::Decrease,
                                                .resultantBalance = getBalance(),
                                            });
     }
+
+    timeManager_.reschedule(getNextEventDate());
+}
+
+Date ServiceChargeCheckingAccount::getNextEventDate() const {
+    // Charged once a full (average length) month has passed, see `update`
+    auto nextCharge = lastServiceCharge_ + std::chrono::ceil<std::chrono::days>(std::chrono::months{1});
+
+    return std::min(nextCharge, getNextStatementDate());
 }
@@ -0,0 +1,709 @@
+#include "snapshot.h"
+#include "account_info.h"
+#include "cd_account.h"
+#include "hi_checking_account.h"
+#include "hi_savings_account.h"
+#include "interest_handler.h"
+#include "monthly_statement.h"
+#include "nosc_checking_account.h"
+#include "savings_account.h"
+#include "sc_checking_account.h"
+#include "util/cow_ptr.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+static_assert(std::endian::native == std::endian::little, "Snapshots are read in place, so share the host byte order");
+
+namespace {
+
+/*
+  File layout, version 1:
+
+    FileHeader
+    IndexRecord for each account, ordered by account number
+    Account data, each starting on an 8 byte boundary:
+      AccountRecord
+      holder name, padded to 8 bytes
+      for each stored month: StatementRecord, then a RecordEntry for each of its records
+
+  Every struct is padded explicitly and holds only fixed width integers, so reading one is a memcpy.
+*/
+constexpr std::array<char, 8> MAGIC{'B', 'A', 'N', 'K', 'S', 'N', 'A', 'P'};
+constexpr std::uint32_t VERSION = 1;
+
+struct FileHeader
+{
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t indexRecordSize;
+    std::uint64_t numAccounts;
+    std::int32_t date;
+    std::int32_t lastUpdate;
+    std::uint64_t indexOffset;
+    std::uint64_t dataOffset;
+    std::uint64_t dataSize;
+    std::uint64_t journalSequence;
+};
+
+struct IndexRecord
+{
+    std::int32_t number;
+    std::uint8_t kind;
+    std::array<std::uint8_t, 3> padding;
+    std::int32_t openingDate;
+    std::uint32_t nameLength;
+    std::uint64_t balance;
+    // Relative to the start of the account data
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+// Holds the state of every account type, leaving whatever a type does not have zeroed
+struct AccountRecord
+{
+    std::int32_t lastMonth;
+    std::uint32_t numStatements;
+    std::int32_t interestLastPayment;
+    std::uint8_t interestType;
+    std::uint8_t isMature;
+    std::array<std::uint8_t, 2> padding;
+    std::int64_t interestRate;
+    std::int64_t earlyWithdrawalPenalty;
+    std::int32_t numMaturityMonths;
+    std::int32_t remainingChecks;
+    std::int32_t lastInterestPayment;
+    std::int32_t lastServiceCharge;
+};
+
+struct StatementRecord
+{
+    std::int32_t start;
+    std::int32_t end;
+    std::uint32_t numRecords;
+    std::uint8_t complete;
+    std::array<std::uint8_t, 3> padding;
+};
+
+struct RecordEntry
+{
+    std::int32_t date;
+    std::uint8_t event;
+    std::uint8_t outcome;
+    std::uint8_t changeType;
+    std::uint8_t padding;
+    std::int32_t counterparty;
+    std::uint32_t padding2;
+    std::uint64_t amount;
+    std::uint64_t minBalance;
+    std::int64_t rate;
+    std::uint64_t balanceChange;
+    std::uint64_t resultantBalance;
+};
+
+static_assert(sizeof(FileHeader) == 64 && sizeof(IndexRecord) == 40 && sizeof(AccountRecord) == 48 &&
+              sizeof(StatementRecord) == 16 && sizeof(RecordEntry) == 56);
+
+constexpr std::size_t ALIGNMENT = 8;
+
+template <typename T>
+void append(std::vector<std::byte>& out, const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto* bytes = reinterpret_cast<const std::byte*>(&value); // NOLINT(*reinterpret-cast)
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void appendPadded(std::vector<std::byte>& out, std::string_view str) {
+    const auto* bytes = reinterpret_cast<const std::byte*>(str.data()); // NOLINT(*reinterpret-cast)
+    out.insert(out.end(), bytes, bytes + str.size());
+    out.resize((out.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+}
+
+std::int32_t toDays(Date date) {
+    return static_cast<std::int32_t>(date.toSysDays().time_since_epoch().count());
+}
+
+Date fromDays(std::int32_t days) {
+    return Date{std::chrono::sys_days{std::chrono::days{days}}};
+}
+
+[[noreturn]] void corrupt() {
+    throw std::runtime_error("Snapshot file is corrupt");
+}
+
+//! Reads consecutive values out of a range of mapped bytes, throwing if they run past the end
+class Cursor
+{
+public:
+    Cursor(const std::byte* data, std::size_t size)
+        : data_{data}
+        , size_{size} {}
+
+    template <typename T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    std::string_view readPadded(std::size_t length) {
+        const auto* chars = reinterpret_cast<const char*>(take(length)); // NOLINT(*reinterpret-cast)
+        take((ALIGNMENT - length % ALIGNMENT) % ALIGNMENT);
+        return {chars, length};
+    }
+
+private:
+    const std::byte* take(std::size_t count) {
+        if (count > size_ - pos_) {
+            corrupt();
+        }
+        const auto* start = data_ + pos_;
+        pos_ += count;
+        return start;
+    }
+
+    const std::byte* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+};
+
+FileHeader readHeader(const std::byte* data, std::size_t size) {
+    return Cursor{data, size}.read<FileHeader>();
+}
+
+void writeAll(int fd, const void* bytes, std::size_t count, const std::filesystem::path& path) {
+    const auto* next = static_cast<const std::byte*>(bytes);
+    while (count > 0) {
+        const auto result = ::write(fd, next, count);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to write snapshot to " + path.string());
+        }
+        next += result;
+        count -= static_cast<std::size_t>(result);
+    }
+}
+
+//! Makes renaming a file to `path` durable, by syncing the directory containing it
+void syncParentDirectory(const std::filesystem::path& path) {
+    auto directory = path.parent_path();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); // NOLINT(*vararg)
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to open " + directory.string());
+    }
+    const int result = ::fsync(fd);
+    const int error = errno;
+    ::close(fd);
+    if (result != 0) {
+        throw std::system_error(error, std::generic_category(), "Failed to sync " + directory.string());
+    }
+}
+
+} // namespace
+
+//! Converts accounts to and from their stored form, with access to the private state of each account type
+class SnapshotCodec
+{
+public:
+    // In the order of AccountKind
+    using AccountTypes = std::tuple<CertificateOfDepositAccount, SavingsAccount, HighInterestSavingsAccount,
+                                    ServiceChargeCheckingAccount, NoServiceChargeCheckingAccount,
+                                    HighInterestCheckingAccount>;
+
+    static void encode(SnapshotWriter& writer, const BankAccount& account) {
+        const bool known = [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            return (encodeIf<std::tuple_element_t<Is, AccountTypes>>(writer, account, static_cast<AccountKind>(Is)) ||
+                    ...);
+        }(std::make_index_sequence<std::tuple_size_v<AccountTypes>>{});
+
+        if (!known) {
+            throw std::invalid_argument("Only the standard account types can be saved to a snapshot");
+        }
+    }
+
+    static BankAccount decode(const Snapshot& snapshot, std::size_t index) {
+        const auto entry = indexRecord(snapshot, index);
+        const auto header = readHeader(snapshot.data_, snapshot.size_);
+        if (entry.offset > header.dataSize || entry.size > header.dataSize - entry.offset) {
+            corrupt();
+        }
+        return decode(entry, Cursor{snapshot.data_ + header.dataOffset + entry.offset, entry.size});
+    }
+
+    static BankAccount decode(const IndexRecord& entry, const Cursor& cursor) {
+        std::optional<BankAccount> account;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((entry.kind == Is ? (account.emplace(decodeAs<std::tuple_element_t<Is, AccountTypes>>(entry, cursor)),
+                                  true)
+                               : false) ||
+             ...);
+        }(std::make_index_sequence<std::tuple_size_v<AccountTypes>>{});
+
+        if (!account) {
+            corrupt();
+        }
+        return std::move(*account);
+    }
+
+    //! A lone account: its IndexRecord, with an offset of zero, followed by its data
+    static std::vector<std::byte> encodeAlone(const BankAccount& account) {
+        SnapshotWriter writer;
+        encode(writer, account);
+        std::vector<std::byte> out;
+        out.reserve(sizeof(IndexRecord) + writer.data_.size());
+        append(out, toIndexRecord(writer.index_.front()));
+        out.insert(out.end(), writer.data_.begin(), writer.data_.end());
+        return out;
+    }
+
+    static BankAccount decodeAlone(std::span<const std::byte> data) {
+        Cursor cursor{data.data(), data.size()};
+        const auto entry = cursor.read<IndexRecord>();
+        if (entry.offset != 0 || entry.size != data.size() - sizeof(IndexRecord)) {
+            corrupt();
+        }
+        return decode(entry, Cursor{data.data() + sizeof(IndexRecord), entry.size});
+    }
+
+    static IndexRecord toIndexRecord(const SnapshotWriter::IndexEntry& entry) {
+        return {
+            .number = entry.number,
+            .kind = static_cast<std::uint8_t>(entry.kind),
+            .padding = {},
+            .openingDate = toDays(entry.openingDate),
+            .nameLength = entry.nameLength,
+            .balance = entry.balance.totalCents(),
+            .offset = entry.offset,
+            .size = entry.size,
+        };
+    }
+
+    static IndexRecord indexRecord(const Snapshot& snapshot, std::size_t index) {
+        const auto header = readHeader(snapshot.data_, snapshot.size_);
+        IndexRecord entry;
+        std::memcpy(&entry, snapshot.data_ + header.indexOffset + index * sizeof(IndexRecord), sizeof(IndexRecord));
+        return entry;
+    }
+
+    static Snapshot::AccountSummary summarize(const Snapshot& snapshot, const IndexRecord& entry) {
+        const auto header = readHeader(snapshot.data_, snapshot.size_);
+        // The holder name directly follows the fixed part of the account
+        const auto nameOffset = header.dataOffset + entry.offset + sizeof(AccountRecord);
+        if (entry.nameLength > snapshot.size_ - std::min(nameOffset, snapshot.size_)) {
+            corrupt();
+        }
+
+        return {
+            .number = entry.number,
+            .kind = static_cast<AccountKind>(entry.kind),
+            .holderName = {reinterpret_cast<const char*>(snapshot.data_ + nameOffset), // NOLINT(*reinterpret-cast)
+                           entry.nameLength},
+            .balance = Money::fromCents(entry.balance),
+            .openingDate = fromDays(entry.openingDate),
+        };
+    }
+
+    static void encodeStatement(std::vector<std::byte>& out, const MonthlyStatement& statement) {
+        append(out, StatementRecord{.start = toDays(statement.start),
+                                    .end = toDays(statement.end),
+                                    .numRecords = static_cast<std::uint32_t>(statement.records.size()),
+                                    .complete = statement.complete ? std::uint8_t{1} : std::uint8_t{0},
+                                    .padding = {}});
+        for (const auto& [date, recordInfo] : statement.records) {
+            append(out, toEntry(date, recordInfo));
+        }
+    }
+
+    static MonthlyStatement decodeStatement(Cursor& cursor) {
+        const auto header = cursor.read<StatementRecord>();
+        MonthlyStatement statement{.start = fromDays(header.start),
+                                   .end = fromDays(header.end),
+                                   .records = {},
+                                   .complete = header.complete != 0};
+        statement.records.reserve(header.numRecords);
+        for (std::uint32_t i = 0; i < header.numRecords; ++i) {
+            const auto stored = cursor.read<RecordEntry>();
+            statement.records.emplace(fromDays(stored.date), fromEntry(stored));
+        }
+        return statement;
+    }
+
+private:
+    template <typename AccountT>
+    static bool encodeIf(SnapshotWriter& writer, const BankAccount& account, AccountKind kind) {
+        const auto* concrete = account.target<AccountT>();
+        if (concrete != nullptr) {
+            encodeAs(writer, *concrete, kind);
+        }
+        return concrete != nullptr;
+    }
+
+    template <typename AccountT>
+    static void encodeAs(SnapshotWriter& writer, const AccountT& account, AccountKind kind) {
+        const AccountInfo& info = account;
+        std::span<const StoredStatement> statements;
+        if (info.monthlyStatements_) {
+            statements = *info.monthlyStatements_;
+        }
+
+        AccountRecord record{};
+        record.lastMonth = info.lastMonth_;
+        record.numStatements = static_cast<std::uint32_t>(statements.size());
+        saveState(account, record);
+
+        auto& out = writer.data_;
+        const auto offset = out.size();
+        append(out, record);
+        appendPadded(out, info.holderName_);
+        for (const auto& stored : statements) {
+            encodeStatement(out, *stored.load());
+        }
+
+        writer.index_.push_back({
+            .number = info.number_,
+            .kind = kind,
+            .openingDate = info.openingDate_,
+            .balance = info.balance_,
+            .nameLength = static_cast<std::uint32_t>(info.holderName_.size()),
+            .offset = offset,
+            .size = out.size() - offset,
+        });
+    }
+
+    template <typename AccountT>
+    static AccountT decodeAs(const IndexRecord& entry, Cursor cursor) {
+        const auto record = cursor.read<AccountRecord>();
+        const auto holderName = cursor.readPadded(entry.nameLength);
+
+        std::vector<StoredStatement> statements;
+        statements.reserve(record.numStatements);
+        for (std::uint32_t i = 0; i < record.numStatements; ++i) {
+            statements.emplace_back(decodeStatement(cursor));
+        }
+
+        AccountInfo info{entry.number, holderName, Money::fromCents(entry.balance), fromDays(entry.openingDate),
+                         record.lastMonth, std::move(statements)};
+        AccountT account = makeAccount<AccountT>(std::move(info), record);
+        restoreState(account, record);
+
+        AccountInfo::skipAccountNumbersThrough(entry.number);
+        account.timeManager_.reschedule(account.getNextEventDate());
+        return account;
+    }
+
+    //! The restored account, registered with SimTimeManager, with any state other than its interest still to be set
+    template <typename AccountT>
+    static AccountT makeAccount(AccountInfo&& info, const AccountRecord& record) {
+        if constexpr (std::same_as<AccountT, ServiceChargeCheckingAccount>) {
+            return AccountT{std::move(info), SimTimeManager{}};
+        } else {
+            return AccountT{std::move(info), decodeInterest(record), SimTimeManager{}};
+        }
+    }
+
+    static InterestHandler decodeInterest(const AccountRecord& record) {
+        if (record.interestType > static_cast<std::uint8_t>(InterestType::Yearly)) {
+            corrupt();
+        }
+        InterestHandler interest{static_cast<InterestType>(record.interestType),
+                                 Rate::fromMillionths(record.interestRate)};
+        interest.lastPayment_ = fromDays(record.interestLastPayment);
+        return interest;
+    }
+
+    template <typename AccountT>
+    static void saveState(const AccountT& account, AccountRecord& record) {
+        if constexpr (requires { account.interestHandler_; }) {
+            const auto& interest = account.interestHandler_;
+            record.interestType = static_cast<std::uint8_t>(interest.compoundingPeriod_);
+            record.interestRate = interest.rate_.millionths();
+            record.interestLastPayment = toDays(interest.lastPayment_);
+        }
+        if constexpr (std::same_as<AccountT, CertificateOfDepositAccount>) {
+            record.isMature = account.isMature_ ? 1 : 0;
+            record.earlyWithdrawalPenalty = account.earlyWithdrawalPenalty_.millionths();
+            record.numMaturityMonths = account.numMaturityMonths_;
+            record.lastInterestPayment = toDays(account.lastInterestPayment_);
+        }
+        if constexpr (std::same_as<AccountT, ServiceChargeCheckingAccount>) {
+            record.remainingChecks = account.remainingChecks_;
+            record.lastServiceCharge = toDays(account.lastServiceCharge_);
+        }
+    }
+
+    template <typename AccountT>
+    static void restoreState(AccountT& account, const AccountRecord& record) {
+        if constexpr (std::same_as<AccountT, CertificateOfDepositAccount>) {
+            account.isMature_ = record.isMature != 0;
+            account.earlyWithdrawalPenalty_ = Rate::fromMillionths(record.earlyWithdrawalPenalty);
+            account.numMaturityMonths_ = record.numMaturityMonths;
+            account.lastInterestPayment_ = fromDays(record.lastInterestPayment);
+        }
+        if constexpr (std::same_as<AccountT, ServiceChargeCheckingAccount>) {
+            account.remainingChecks_ = record.remainingChecks;
+            account.lastServiceCharge_ = fromDays(record.lastServiceCharge);
+        }
+    }
+
+    static RecordEntry toEntry(Date date, const StatementRecordInfo& info) {
+        return {
+            .date = toDays(date),
+            .event = static_cast<std::uint8_t>(info.event),
+            .outcome = static_cast<std::uint8_t>(info.outcome),
+            .changeType = static_cast<std::uint8_t>(info.changeType),
+            .padding = 0,
+            .counterparty = info.counterparty,
+            .padding2 = 0,
+            .amount = info.amount.totalCents(),
+            .minBalance = info.minBalance.totalCents(),
+            .rate = info.rate.millionths(),
+            .balanceChange = info.balanceChange.totalCents(),
+            .resultantBalance = info.resultantBalance.totalCents(),
+        };
+    }
+
+    static StatementRecordInfo fromEntry(const RecordEntry& entry) {
+        using Event = StatementRecordInfo::Event;
+        using Outcome = StatementRecordInfo::Outcome;
+        const auto changeType = static_cast<char>(entry.changeType);
+        if (entry.event > static_cast<std::uint8_t>(Event::TransferOut) ||
+            entry.outcome > static_cast<std::uint8_t>(Outcome::ActionBelowMinimumBalance) ||
+            (changeType != StatementRecordInfo::Increase && changeType != StatementRecordInfo::Decrease &&
+             changeType != StatementRecordInfo::None)) {
+            corrupt();
+        }
+
+        return {
+            .event = static_cast<Event>(entry.event),
+            .outcome = static_cast<Outcome>(entry.outcome),
+            .counterparty = entry.counterparty,
+            .amount = Money::fromCents(entry.amount),
+            .minBalance = Money::fromCents(entry.minBalance),
+            .rate = Rate::fromMillionths(entry.rate),
+            .balanceChange = Money::fromCents(entry.balanceChange),
+            .changeType = static_cast<decltype(StatementRecordInfo::changeType)>(changeType),
+            .resultantBalance = Money::fromCents(entry.resultantBalance),
+        };
+    }
+};
+
+void SnapshotWriter::add(const BankAccount& account) {
+    SnapshotCodec::encode(*this, account);
+}
+
+void SnapshotWriter::write(const std::filesystem::path& path) const {
+    std::vector<const IndexEntry*> sorted;
+    sorted.reserve(index_.size());
+    for (const auto& entry : index_) {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto* lhs, const auto* rhs) { return lhs->number < rhs->number; });
+
+    FileHeader header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.indexRecordSize = sizeof(IndexRecord);
+    header.numAccounts = index_.size();
+    header.date = toDays(SimTimeManager::getDate());
+    header.lastUpdate = toDays(SimTimeManager::getLastUpdate());
+    header.indexOffset = sizeof(FileHeader);
+    header.dataOffset = header.indexOffset + index_.size() * sizeof(IndexRecord);
+    header.dataSize = data_.size();
+    header.journalSequence = journalSequence_;
+
+    std::vector<std::byte> index;
+    index.reserve(index_.size() * sizeof(IndexRecord));
+    for (const auto* entry : sorted) {
+        append(index, SnapshotCodec::toIndexRecord(*entry));
+    }
+
+    auto tempPath = path;
+    tempPath += ".tmp";
+    const int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644); // NOLINT(*vararg)
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to create " + tempPath.string());
+    }
+    try {
+        writeAll(fd, &header, sizeof(header), tempPath);
+        writeAll(fd, index.data(), index.size(), tempPath);
+        writeAll(fd, data_.data(), data_.size(), tempPath);
+        // The contents must be on disk before the rename can expose them under `path`
+        if (::fsync(fd) != 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to sync " + tempPath.string());
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to write snapshot to " + tempPath.string());
+    }
+
+    std::filesystem::rename(tempPath, path);
+    syncParentDirectory(path);
+}
+
+void writeSnapshot(const std::filesystem::path& path, const AccountStore<BankAccount>& accounts,
+                   std::uint64_t journalSequence) {
+    SnapshotWriter writer;
+    for (const auto& account : accounts) {
+        writer.add(account);
+    }
+    writer.setJournalSequence(journalSequence);
+    writer.write(path);
+}
+
+std::vector<std::byte> encodeAccount(const BankAccount& account) {
+    return SnapshotCodec::encodeAlone(account);
+}
+
+BankAccount decodeAccount(std::span<const std::byte> data) {
+    return SnapshotCodec::decodeAlone(data);
+}
+
+void encodeStatement(const MonthlyStatement& statement, std::vector<std::byte>& out) {
+    SnapshotCodec::encodeStatement(out, statement);
+}
+
+MonthlyStatement decodeStatement(std::span<const std::byte> data) {
+    Cursor cursor{data.data(), data.size()};
+    return SnapshotCodec::decodeStatement(cursor);
+}
+
+Snapshot::Snapshot(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(*vararg)
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to open snapshot " + path.string());
+    }
+
+    struct stat info{};
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error(path.string() + " is not a snapshot");
+    }
+
+    size_ = static_cast<std::size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) { // NOLINT(*cstyle-cast)
+        throw std::system_error(errno, std::generic_category(), "Failed to map snapshot " + path.string());
+    }
+    data_ = static_cast<const std::byte*>(mapped);
+
+    const auto header = readHeader(data_, size_);
+    const bool valid = header.magic == MAGIC && header.indexRecordSize == sizeof(IndexRecord) &&
+                       header.indexOffset == sizeof(FileHeader) &&
+                       header.numAccounts <= (size_ - header.indexOffset) / sizeof(IndexRecord) &&
+                       header.dataOffset == header.indexOffset + header.numAccounts * sizeof(IndexRecord) &&
+                       header.dataSize == size_ - header.dataOffset;
+    if (!valid || header.version != VERSION) {
+        unmap();
+        throw std::runtime_error(valid ? "Unsupported snapshot version " + std::to_string(header.version)
+                                       : path.string() + " is not a snapshot");
+    }
+}
+
+Snapshot::Snapshot(Snapshot&& other) noexcept
+    : data_{std::exchange(other.data_, nullptr)}
+    , size_{std::exchange(other.size_, 0)} {}
+
+Snapshot& Snapshot::operator=(Snapshot&& rhs) noexcept {
+    if (&rhs == this) {
+        return *this;
+    }
+
+    unmap();
+    data_ = std::exchange(rhs.data_, nullptr);
+    size_ = std::exchange(rhs.size_, 0);
+    return *this;
+}
+
+Snapshot::~Snapshot() {
+    unmap();
+}
+
+void Snapshot::unmap() noexcept {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<std::byte*>(data_), size_); // NOLINT(*const-cast)
+        data_ = nullptr;
+    }
+}
+
+Date Snapshot::getDate() const {
+    return fromDays(readHeader(data_, size_).date);
+}
+
+std::uint64_t Snapshot::journalSequence() const {
+    return readHeader(data_, size_).journalSequence;
+}
+
+void Snapshot::restoreTime() const {
+    const auto header = readHeader(data_, size_);
+    SimTimeManager::restore(fromDays(header.date), fromDays(header.lastUpdate));
+}
+
+std::size_t Snapshot::size() const {
+    return static_cast<std::size_t>(readHeader(data_, size_).numAccounts);
+}
+
+Snapshot::AccountSummary Snapshot::summary(std::size_t index) const {
+    if (index >= size()) {
+        throw std::out_of_range("No account at this index of the snapshot");
+    }
+    return SnapshotCodec::summarize(*this, SnapshotCodec::indexRecord(*this, index));
+}
+
+std::optional<Snapshot::AccountSummary> Snapshot::find(int number) const {
+    // The index is sorted by number
+    std::size_t low = 0;
+    std::size_t high = size();
+    while (low < high) {
+        const auto mid = low + (high - low) / 2;
+        const auto entry = SnapshotCodec::indexRecord(*this, mid);
+        if (entry.number == number) {
+            return SnapshotCodec::summarize(*this, entry);
+        }
+        if (entry.number < number) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return std::nullopt;
+}
+
+BankAccount Snapshot::load(std::size_t index) const {
+    if (index >= size()) {
+        throw std::out_of_range("No account at this index of the snapshot");
+    }
+    return SnapshotCodec::decode(*this, index);
+}
+
+void Snapshot::loadInto(AccountStore<BankAccount>& accounts) const {
+    restoreTime();
+    for (std::size_t i = 0; i < size(); ++i) {
+        accounts.insert(load(i));
+    }
+}
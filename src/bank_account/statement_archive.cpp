@@ -0,0 +1,178 @@
+#include "statement_archive.h"
+#include "snapshot.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/*
+  Each statement is stored as an EntryHeader, then the statement as encoded in a snapshot, padded to 8 bytes.
+*/
+struct EntryHeader
+{
+    std::int32_t number;
+    std::int32_t month;
+    std::uint64_t size;
+};
+
+static_assert(sizeof(EntryHeader) == 16);
+
+constexpr std::size_t ALIGNMENT = 8;
+
+std::mutex activeMutex;                          // NOLINT(*non-const-global-variables)
+std::shared_ptr<StatementArchive> activeArchive; // NOLINT(*non-const-global-variables)
+// Checked first, so accounts do not contend for the lock at the end of every month while nothing is archived
+std::atomic<bool> anyActive = false; // NOLINT(*non-const-global-variables)
+
+} // namespace
+
+StatementArchive::StatementArchive(const std::filesystem::path& path)
+    : StatementArchive(path, Options{}) {}
+
+StatementArchive::StatementArchive(const std::filesystem::path& path, Options options)
+    : path_{path}
+    , options_{options} {
+    fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600); // NOLINT(*vararg)
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to create statement archive " + path_.string());
+    }
+}
+
+StatementArchive::~StatementArchive() {
+    ::close(fd_);
+    std::error_code error;
+    std::filesystem::remove(path_, error);
+}
+
+void StatementArchive::setActive(std::shared_ptr<StatementArchive> archive) {
+    const std::lock_guard lock{activeMutex};
+    anyActive = archive != nullptr;
+    activeArchive = std::move(archive);
+}
+
+std::shared_ptr<StatementArchive> StatementArchive::active() {
+    if (!anyActive) {
+        return nullptr;
+    }
+    const std::lock_guard lock{activeMutex};
+    return activeArchive;
+}
+
+std::size_t StatementArchive::size() const {
+    const std::lock_guard lock{mutex_};
+    return numStatements_;
+}
+
+std::size_t StatementArchive::numReads() const {
+    const std::lock_guard lock{mutex_};
+    return numReads_;
+}
+
+std::pair<std::uint64_t, std::uint64_t> StatementArchive::add(int number, const MonthlyStatement& statement) {
+    std::vector<std::byte> entry(sizeof(EntryHeader));
+    encodeStatement(statement, entry);
+    const EntryHeader header{.number = number,
+                             .month = statement.start.monthIndex(),
+                             .size = entry.size() - sizeof(EntryHeader)};
+    std::memcpy(entry.data(), &header, sizeof(header));
+    entry.resize((entry.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+
+    const std::lock_guard lock{mutex_};
+    const auto offset = fileSize_;
+    std::size_t written = 0;
+    while (written < entry.size()) {
+        const auto result =
+            ::pwrite(fd_, entry.data() + written, entry.size() - written, static_cast<off_t>(offset + written));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to write statement archive");
+        }
+        written += static_cast<std::size_t>(result);
+    }
+
+    fileSize_ += entry.size();
+    ++numStatements_;
+    return {offset, entry.size()};
+}
+
+std::shared_ptr<const MonthlyStatement> StatementArchive::load(std::uint64_t offset, std::uint64_t size,
+                                                              std::int32_t month) {
+    {
+        const std::lock_guard lock{mutex_};
+        if (auto iter = cacheIndex_.find(offset); iter != cacheIndex_.end()) {
+            cache_.splice(cache_.begin(), cache_, iter->second);
+            return iter->second->second;
+        }
+        ++numReads_;
+    }
+
+    // Read without holding the lock, so other statements can be archived meanwhile
+    std::vector<std::byte> entry(size);
+    std::size_t numRead = 0;
+    while (numRead < entry.size()) {
+        const auto result =
+            ::pread(fd_, entry.data() + numRead, entry.size() - numRead, static_cast<off_t>(offset + numRead));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            throw std::runtime_error("Failed to read statement archive");
+        }
+        numRead += static_cast<std::size_t>(result);
+    }
+
+    EntryHeader header{};
+    std::memcpy(&header, entry.data(), std::min<std::size_t>(sizeof(header), entry.size()));
+    if (entry.size() < sizeof(header) || header.month != month || header.size > entry.size() - sizeof(header)) {
+        throw std::runtime_error("Statement archive does not match its index");
+    }
+    auto statement = std::make_shared<const MonthlyStatement>(
+        decodeStatement(std::span{entry}.subspan(sizeof(header), static_cast<std::size_t>(header.size))));
+
+    const std::lock_guard lock{mutex_};
+    if (cacheIndex_.contains(offset) || options_.cacheSize == 0) {
+        return statement;
+    }
+    cache_.emplace_front(offset, statement);
+    cacheIndex_.emplace(offset, cache_.begin());
+    if (cache_.size() > options_.cacheSize) {
+        cacheIndex_.erase(cache_.back().first);
+        cache_.pop_back();
+    }
+    return statement;
+}
+
+std::shared_ptr<const MonthlyStatement> StoredStatement::load() const {
+    if (archive_ != nullptr) {
+        return archive_->load(offset_, size_, month_);
+    }
+    return resident_.share();
+}
+
+MonthlyStatement& StoredStatement::mutate() {
+    if (archive_ != nullptr) {
+        resident_ = util::CowPtr{MonthlyStatement{*load()}};
+        archive_.reset();
+    }
+    return resident_.mutate();
+}
+
+void StoredStatement::archiveTo(std::shared_ptr<StatementArchive> archive, int number) {
+    std::tie(offset_, size_) = archive->add(number, *resident_);
+    archive_ = std::move(archive);
+    resident_ = util::CowPtr<MonthlyStatement>{};
+}
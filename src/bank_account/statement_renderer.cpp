@@ -0,0 +1,66 @@
+#include "statement_renderer.h"
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+void StatementRenderer::render(const MonthlyStatement& statement) {
+    fmt::format_to(fmt::appender(buffer_), "{}", statement);
+}
+
+void StatementRenderer::renderAll(const BankAccount& account) {
+    bool first = true;
+    for (const auto& statement : account.getAllMonthlyStatements()) {
+        if (!first) {
+            append("\n\n");
+        }
+        render(statement);
+        first = false;
+    }
+}
+
+StatementExporter::StatementExporter(const std::filesystem::path& path, std::size_t bufferSize)
+    : file_{path, std::ios::binary | std::ios::trunc}
+    , bufferSize_{bufferSize} {
+    if (!file_) {
+        throw std::runtime_error("Failed to create " + path.string());
+    }
+}
+
+StatementExporter::~StatementExporter() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // Only reported when flushing explicitly
+    }
+}
+
+void StatementExporter::add(const BankAccount& account) {
+    renderer_.append("Account {} owned by {}, opened {:%D}\n\n", account.getAccountNumber(), account.getAccountName(),
+                     account.getAccountOpeningDate());
+    renderer_.renderAll(account);
+    renderer_.append("\n\n");
+    ++numAccounts_;
+
+    if (renderer_.size() >= bufferSize_) {
+        flush();
+    }
+}
+
+void StatementExporter::flush() {
+    const auto text = renderer_.view();
+    file_.write(text.data(), static_cast<std::streamsize>(text.size()));
+    file_.flush();
+    renderer_.clear();
+    if (!file_) {
+        throw std::runtime_error("Failed to write statements");
+    }
+}
+
+void exportStatements(const std::filesystem::path& path, const AccountStore<BankAccount>& accounts) {
+    StatementExporter exporter{path};
+    for (const auto& account : accounts) {
+        exporter.add(account);
+    }
+    exporter.flush();
+}
@@ -0,0 +1,163 @@
+#include "transaction_engine.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <utility>
+
+namespace {
+
+std::size_t pickNumShards(std::size_t requested) {
+    if (requested != 0) {
+        return requested;
+    }
+
+    // Enough that threads working on random accounts rarely wait for each other
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1) * 16;
+}
+
+} // namespace
+
+TransactionEngine::TransactionEngine(std::size_t numShards)
+    : numShards_{pickNumShards(numShards)}
+    , shards_{std::make_unique<Shard[]>(numShards_)} {} // NOLINT(*c-arrays)
+
+int TransactionEngine::open(BankAccount account) {
+    return insert(std::move(account));
+}
+
+int TransactionEngine::insert(BankAccount account) {
+    // Creating the account has already registered it with its time manager, which does its own locking
+    const int number = account.getAccountNumber();
+    auto& shard = shardOf(number);
+
+    const std::lock_guard lock{shard.mutex};
+    shard.accounts.insert(std::move(account));
+    return number;
+}
+
+bool TransactionEngine::close(int number) {
+    auto& shard = shardOf(number);
+
+    const std::lock_guard lock{shard.mutex};
+    return shard.accounts.close(number);
+}
+
+bool TransactionEngine::deposit(int number, Money amount) {
+    const std::array batch{Transaction{Transaction::Type::Deposit, amount}};
+    return apply(number, batch) == 1;
+}
+
+bool TransactionEngine::withdraw(int number, Money amount) {
+    const std::array batch{Transaction{Transaction::Type::Withdrawal, amount}};
+    return apply(number, batch) == 1;
+}
+
+bool TransactionEngine::writeCheck(int number, Money amount) {
+    const std::array batch{Transaction{Transaction::Type::Check, amount}};
+    return apply(number, batch) == 1;
+}
+
+std::size_t TransactionEngine::apply(int number, std::span<const Transaction> batch) {
+    return withAccount(number, [&](BankAccount& account) { return account.apply(batch); });
+}
+
+bool TransactionEngine::transfer(int from, int to, Money amount) {
+    const auto low = std::min(shardIndex(from), shardIndex(to));
+    const auto high = std::max(shardIndex(from), shardIndex(to));
+
+    const std::lock_guard lowLock{shards_[low].mutex};
+    std::unique_lock highLock{shards_[high].mutex, std::defer_lock};
+    if (high != low) {
+        highLock.lock();
+    }
+
+    auto& fromAccount = get(shardOf(from), from);
+    auto& toAccount = get(shardOf(to), to);
+    checkTransfer(from, toAccount);
+    return moveFunds(fromAccount, toAccount, amount);
+}
+
+std::size_t TransactionEngine::transferBatch(std::span<const Transfer> batch) {
+    std::vector<std::size_t> involved;
+    involved.reserve(batch.size() * 2);
+    for (const auto& transfer : batch) {
+        involved.push_back(shardIndex(transfer.from));
+        involved.push_back(shardIndex(transfer.to));
+    }
+    std::sort(involved.begin(), involved.end());
+    involved.erase(std::unique(involved.begin(), involved.end()), involved.end());
+
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(involved.size());
+    for (auto index : involved) {
+        locks.emplace_back(shards_[index].mutex);
+    }
+
+    // Both accounts of every transfer must exist before any of them is applied
+    for (const auto& transfer : batch) {
+        get(shardOf(transfer.from), transfer.from);
+        checkTransfer(transfer.from, get(shardOf(transfer.to), transfer.to));
+    }
+
+    std::size_t numSucceeded = 0;
+    for (const auto& transfer : batch) {
+        if (moveFunds(get(shardOf(transfer.from), transfer.from), get(shardOf(transfer.to), transfer.to),
+                      transfer.amount)) {
+            ++numSucceeded;
+        }
+    }
+    return numSucceeded;
+}
+
+Money TransactionEngine::getBalance(int number) const {
+    return withAccount(number, [](const BankAccount& account) { return account.getBalance(); });
+}
+
+std::size_t TransactionEngine::size() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < numShards_; ++i) {
+        const std::lock_guard lock{shards_[i].mutex};
+        total += shards_[i].accounts.size();
+    }
+    return total;
+}
+
+BankAccount& TransactionEngine::get(Shard& shard, int number) {
+    auto* account = shard.accounts.find(number);
+    if (account == nullptr) {
+        throw std::out_of_range("No open account with this number");
+    }
+    return *account;
+}
+
+const BankAccount& TransactionEngine::get(const Shard& shard, int number) {
+    const auto* account = shard.accounts.find(number);
+    if (account == nullptr) {
+        throw std::out_of_range("No open account with this number");
+    }
+    return *account;
+}
+
+void TransactionEngine::checkTransfer(int from, const BankAccount& to) {
+    if (from == to.getAccountNumber()) {
+        throw std::invalid_argument("Cannot transfer from an account to itself");
+    }
+    if (!to.acceptsDeposits()) {
+        throw std::invalid_argument("Money cannot be transferred into this account");
+    }
+}
+
+bool TransactionEngine::moveFunds(BankAccount& from, BankAccount& to, Money amount) {
+    if (!from.transferOut(amount, to.getAccountNumber())) {
+        return false;
+    }
+
+    to.transferIn(amount, from.getAccountNumber());
+    return true;
+}
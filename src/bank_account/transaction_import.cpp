@@ -0,0 +1,431 @@
+#include "transaction_import.h"
+#include "money_type.h"
+#include "transaction.h"
+#include "util/date_util.h"
+#include "util/thread_pool.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace {
+
+//! Read-only mapping of a whole file
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::filesystem::path& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(*vararg)
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Failed to open " + path.string());
+        }
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Failed to read " + path.string());
+        }
+
+        size_ = static_cast<std::size_t>(info.st_size);
+        // Nothing to map in an empty file, and mmap rejects a length of 0
+        if (size_ == 0) {
+            ::close(fd);
+            return;
+        }
+        void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) { // NOLINT(*cstyle-cast)
+            throw std::system_error(errno, std::generic_category(), "Failed to map " + path.string());
+        }
+        ::madvise(mapped, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(mapped);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(const_cast<char*>(data_), size_); // NOLINT(*const-cast)
+        }
+    }
+
+    std::string_view text() const { return {data_, size_}; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+struct Row
+{
+    int number;
+    Date date;
+    Transaction transaction;
+    std::size_t line;
+};
+
+//! Rows parsed from one chunk of the file, with line numbers counted from the start of the chunk
+struct ParsedChunk
+{
+    std::vector<Row> rows;
+    std::vector<ImportReport::Rejection> rejections;
+    std::size_t numRejected = 0;
+    std::size_t numLines = 0;
+};
+
+//! Splits `text` into fields separated by commas, where a field may be quoted to contain commas
+/*!
+  Returns how many fields were found, or 0 if there are more than `fields` has room for or a quote is left open.
+*/
+std::size_t splitFields(std::string_view text, std::span<std::string_view> fields) {
+    std::size_t count = 0;
+    while (count < fields.size()) {
+        std::size_t end = 0;
+        if (!text.empty() && text.front() == '"') {
+            end = text.find('"', 1);
+            if (end == std::string_view::npos) {
+                return 0;
+            }
+            fields[count++] = text.substr(1, end - 1);
+            ++end;
+            if (end != text.size() && text[end] != ',') {
+                return 0;
+            }
+        } else {
+            end = std::min(text.find(','), text.size());
+            fields[count++] = text.substr(0, end);
+        }
+
+        if (end == text.size()) {
+            return count;
+        }
+        text.remove_prefix(end + 1);
+    }
+    // More fields than expected
+    return 0;
+}
+
+template <typename IntType>
+bool parseInt(std::string_view text, IntType& value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc{} && end == text.data() + text.size();
+}
+
+//! Reads a `YYYY-MM-DD` date
+bool parseDate(std::string_view text, Date& date) {
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-' || !parseInt(text.substr(0, 4), year) ||
+        !parseInt(text.substr(5, 2), month) || !parseInt(text.substr(8, 2), day)) {
+        return false;
+    }
+
+    const std::chrono::year_month_day ymd{std::chrono::year{year}, std::chrono::month{month}, std::chrono::day{day}};
+    if (!ymd.ok()) {
+        return false;
+    }
+    date = Date{ymd};
+    return true;
+}
+
+bool parseType(std::string_view text, Transaction::Type& type) {
+    using enum Transaction::Type;
+    if (text == "deposit") {
+        type = Deposit;
+    } else if (text == "withdrawal") {
+        type = Withdrawal;
+    } else if (text == "check") {
+        type = Check;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+//! Returns why `line` is not a valid row, or nothing if it is, in which case `row` is filled in
+const char* parseRow(std::string_view line, Row& row) {
+    std::array<std::string_view, 4> fields;
+    if (splitFields(line, fields) != fields.size()) {
+        return "Expected 4 fields: account,date,type,amount";
+    }
+    if (!parseInt(fields[0], row.number)) {
+        return "Invalid account number";
+    }
+    if (!parseDate(fields[1], row.date)) {
+        return "Invalid date, expected YYYY-MM-DD";
+    }
+    if (!parseType(fields[2], row.transaction.type)) {
+        return "Unknown transaction type, expected deposit, withdrawal or check";
+    }
+    const auto [end, error] = parseMoney(fields[3], row.transaction.amount);
+    if (error != std::errc{} || end != fields[3].data() + fields[3].size()) {
+        return "Invalid amount";
+    }
+    return nullptr;
+}
+
+void reject(std::vector<ImportReport::Rejection>& rejections, std::size_t& numRejected, std::size_t maxRejections,
+            std::size_t line, std::string reason) {
+    ++numRejected;
+    if (rejections.size() < maxRejections) {
+        rejections.push_back({line, std::move(reason)});
+    }
+}
+
+ParsedChunk parseChunk(std::string_view text, bool first, const ImportOptions& options) {
+    ParsedChunk chunk;
+    // Rows are rarely shorter than this, so the reservation is seldom exceeded
+    constexpr std::size_t MIN_ROW_SIZE = 32;
+    chunk.rows.reserve(text.size() / MIN_ROW_SIZE);
+
+    while (!text.empty()) {
+        const auto lineEnd = std::min(text.find('\n'), text.size());
+        auto line = text.substr(0, lineEnd);
+        text.remove_prefix(std::min(lineEnd + 1, text.size()));
+        ++chunk.numLines;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        const bool isHeader =
+            first && chunk.numLines == 1 && !line.empty() && (line.front() < '0' || line.front() > '9');
+        if (line.empty() || isHeader) {
+            continue;
+        }
+
+        Row row{};
+        row.line = chunk.numLines;
+        if (const char* reason = parseRow(line, row)) {
+            reject(chunk.rejections, chunk.numRejected, options.maxRejections, row.line, reason);
+            continue;
+        }
+        chunk.rows.push_back(row);
+    }
+
+    return chunk;
+}
+
+//! Parses every row of `text` on `pool`, returning them in file order with their line numbers in the file
+std::vector<Row> parseAll(std::string_view text, util::ThreadPool& pool, const ImportOptions& options,
+                          ImportReport& report) {
+    // Chunks end just after a newline, so no row is split between two of them
+    std::vector<std::string_view> pieces;
+    const auto chunkSize = std::max<std::size_t>(options.chunkSize, 1);
+    while (!text.empty()) {
+        auto end = std::min(chunkSize, text.size());
+        end = std::min(text.find('\n', end - 1), text.size() - 1) + 1;
+        pieces.push_back(text.substr(0, end));
+        text.remove_prefix(end);
+    }
+
+    std::vector<ParsedChunk> chunks(pieces.size());
+    pool.parallelFor(pieces.size(), 1,
+                     [&](std::size_t i) { chunks[i] = parseChunk(pieces[i], i == 0, options); });
+
+    std::size_t numRows = 0;
+    for (const auto& chunk : chunks) {
+        numRows += chunk.rows.size();
+    }
+
+    std::vector<Row> rows;
+    rows.reserve(numRows);
+    std::size_t firstLine = 0;
+    for (auto& chunk : chunks) {
+        for (auto& row : chunk.rows) {
+            row.line += firstLine;
+            rows.push_back(row);
+        }
+        for (auto& rejection : chunk.rejections) {
+            reject(report.rejections, report.numRejected, options.maxRejections, rejection.line + firstLine,
+                   std::move(rejection.reason));
+        }
+        // Rejections past the limit were only counted
+        report.numRejected += chunk.numRejected - chunk.rejections.size();
+        firstLine += chunk.numLines;
+    }
+
+    report.numRows = rows.size() + report.numRejected;
+    return rows;
+}
+
+using ApplyFn = std::function<std::size_t(int number, std::span<const Transaction> batch)>;
+using StepFn = std::function<void(std::chrono::days days)>;
+
+//! What happened to one account's batch on one date
+struct BatchResult
+{
+    std::size_t numSucceeded = 0;
+    // Empty if the batch was applied
+    std::string error;
+    // Whether the error only rejected the checks of the batch, with the other rows applied without them
+    bool checksRejected = false;
+};
+
+bool isCheck(const Transaction& transaction) {
+    return transaction.type == Transaction::Type::Check;
+}
+
+//! Applies one account's batch, leaving its checks out if the account does not take them
+BatchResult applyBatch(const ApplyFn& apply, int number, std::span<const Transaction> batch) {
+    BatchResult result;
+    try {
+        result.numSucceeded = apply(number, batch);
+        return result;
+    } catch (const std::out_of_range&) {
+        result.error = "Account " + std::to_string(number) + " is not open";
+        return result;
+    } catch (const std::invalid_argument& error) {
+        result.error = error.what();
+    }
+
+    // Accounts refuse checks before applying anything, so the rest of the batch can still be applied on its own
+    if (std::none_of(batch.begin(), batch.end(), isCheck)) {
+        return result;
+    }
+    std::vector<Transaction> rest;
+    std::remove_copy_if(batch.begin(), batch.end(), std::back_inserter(rest), isCheck);
+    try {
+        result.numSucceeded = rest.empty() ? 0 : apply(number, rest);
+        result.checksRejected = true;
+    } catch (const std::invalid_argument&) {
+        // Refused for some other reason, so the whole batch stays rejected
+    }
+    return result;
+}
+
+ImportReport runImport(const std::filesystem::path& path, const ImportOptions& options, const ApplyFn& apply,
+                       const StepFn& step) {
+    const auto start = std::chrono::steady_clock::now();
+    ImportReport report;
+
+    const MappedFile file{path};
+    const auto numThreads = options.numThreads > 0 ? options.numThreads
+                                                   : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    util::ThreadPool pool{numThreads};
+
+    auto rows = parseAll(file.text(), pool, options, report);
+
+    // Grouped by date, then by account within each date, keeping each account's rows in file order
+    std::stable_sort(rows.begin(), rows.end(), [](const Row& lhs, const Row& rhs) {
+        return lhs.date != rhs.date ? lhs.date < rhs.date : lhs.number < rhs.number;
+    });
+    std::vector<Transaction> transactions(rows.size());
+    std::transform(rows.begin(), rows.end(), transactions.begin(), [](const Row& row) { return row.transaction; });
+
+    struct Batch
+    {
+        std::size_t begin;
+        std::size_t end;
+    };
+    std::vector<Batch> batches;
+    std::vector<BatchResult> results;
+    // Rejected rows are found out of line order, so are collected and sorted at the end
+    std::vector<ImportReport::Rejection> rejections = std::move(report.rejections);
+
+    for (std::size_t dayBegin = 0; dayBegin < rows.size();) {
+        const auto date = rows[dayBegin].date;
+        std::size_t dayEnd = dayBegin;
+        batches.clear();
+        while (dayEnd < rows.size() && rows[dayEnd].date == date) {
+            const auto batchBegin = dayEnd;
+            const auto number = rows[batchBegin].number;
+            while (dayEnd < rows.size() && rows[dayEnd].date == date && rows[dayEnd].number == number) {
+                ++dayEnd;
+            }
+            batches.push_back({batchBegin, dayEnd});
+        }
+
+        const auto today = SimTimeManager::getDate();
+        if (date < today) {
+            for (std::size_t i = dayBegin; i < dayEnd; ++i) {
+                reject(rejections, report.numRejected, options.maxRejections, rows[i].line,
+                       "Dated before the simulated date");
+            }
+            dayBegin = dayEnd;
+            continue;
+        }
+        if (today < date) {
+            step(std::chrono::days{Date::diff(today, date)});
+        }
+
+        results.assign(batches.size(), BatchResult{});
+        // Many accounts only have a row or two a day, so they are handed out a few at a time
+        constexpr std::size_t GRAIN = 16;
+        pool.parallelFor(batches.size(), GRAIN, [&](std::size_t i) {
+            const auto [begin, end] = batches[i];
+            results[i] = applyBatch(apply, rows[begin].number, std::span{transactions}.subspan(begin, end - begin));
+        });
+
+        for (std::size_t i = 0; i < batches.size(); ++i) {
+            const auto [begin, end] = batches[i];
+            report.numSucceeded += results[i].numSucceeded;
+            for (std::size_t row = begin; row < end; ++row) {
+                const bool rejected =
+                    !results[i].error.empty() && (!results[i].checksRejected || isCheck(rows[row].transaction));
+                if (rejected) {
+                    reject(rejections, report.numRejected, options.maxRejections, rows[row].line, results[i].error);
+                } else {
+                    ++report.numApplied;
+                }
+            }
+        }
+        dayBegin = dayEnd;
+    }
+
+    std::sort(rejections.begin(), rejections.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.line < rhs.line; });
+    report.rejections = std::move(rejections);
+    report.elapsed = std::chrono::steady_clock::now() - start;
+    return report;
+}
+
+} // namespace
+
+ImportReport importTransactions(const std::filesystem::path& path, TransactionEngine& engine,
+                                const ImportOptions& options) {
+    return runImport(
+        path, options,
+        [&engine](int number, std::span<const Transaction> batch) { return engine.apply(number, batch); },
+        [&engine](std::chrono::days days) {
+            engine.exclusively([days] {
+                SimTimeManager::incrDay(days);
+                SimTimeManager::updateAll();
+            });
+        });
+}
+
+ImportReport importTransactions(const std::filesystem::path& path, AccountStore<BankAccount>& accounts,
+                                const ImportOptions& options) {
+    return runImport(
+        path, options,
+        [&accounts](int number, std::span<const Transaction> batch) {
+            auto* account = accounts.find(number);
+            if (account == nullptr) {
+                throw std::out_of_range("Account is not open");
+            }
+            return account->apply(batch);
+        },
+        [](std::chrono::days days) {
+            SimTimeManager::incrDay(days);
+            SimTimeManager::updateAll();
+        });
+}
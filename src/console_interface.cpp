@@ -4,9 +4,13 @@
 #include "hi_checking_account.h"
 #include "hi_savings_account.h"
 #include "interest_handler.h"
+#include "money_type.h"
 #include "nosc_checking_account.h"
 #include "savings_account.h"
 #include "sc_checking_account.h"
+#include "snapshot.h"
+#include "statement_renderer.h"
+#include "transaction.h"
 #include "util/date_util.h"
 
 #include <fmt/color.h>
@@ -15,7 +19,9 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <filesystem>
 #include <iostream>
 #include <iterator>
 #include <optional>
@@ -23,6 +29,8 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -56,8 +64,49 @@ std::optional<int> getIntInput() {
     return std::optional{result};
 }
 
+std::optional<Money> getMoneyInput() {
+    std::string rawInput;
+    std::getline(std::cin, rawInput);
+    Money result;
+
+    const auto [end, error] = parseMoney(rawInput, result);
+    if (error == std::errc::result_out_of_range) {
+        errorMsg("Amount is out of range!");
+        return std::nullopt;
+    }
+    if (error != std::errc{} || end != rawInput.data() + rawInput.size()) {
+        errorMsg("Not a valid amount!");
+        return std::nullopt;
+    }
+
+    return std::optional{result};
+}
+
 } // namespace
 
+ConsoleInterface::ConsoleInterface(std::filesystem::path snapshotPath)
+    : snapshotPath_{std::move(snapshotPath)} {
+    std::uint64_t journalSequence = 0;
+    if (std::filesystem::exists(*snapshotPath_)) {
+        const Snapshot snapshot{*snapshotPath_};
+        snapshot.loadInto(openAccounts_);
+        journalSequence = snapshot.journalSequence();
+        successMsg("Loaded {} accounts from {}. The date is {:%D}", snapshot.size(), snapshotPath_->string(),
+                   SimTimeManager::getDate());
+    } else {
+        successMsg("No snapshot at {} yet. It will be created on quitting.", snapshotPath_->string());
+    }
+
+    auto journalPath = *snapshotPath_;
+    journalPath += ".journal";
+    journal_.emplace(journalPath);
+    const auto numReplayed = journal_->replay(openAccounts_, journalSequence);
+    if (numReplayed > 0) {
+        successMsg("Replayed {} operations from {}. The date is {:%D}", numReplayed, journalPath.string(),
+                   SimTimeManager::getDate());
+    }
+}
+
 void ConsoleInterface::run() {
     using enum MainMenuOption;
     using enum AccountMenuOption;
@@ -80,6 +129,9 @@ void ConsoleInterface::run() {
                 break;
             }
 
+            if (journal_) {
+                journal_->recordTimeStep(std::chrono::days{numSelection.value()});
+            }
             SimTimeManager::incrDay(std::chrono::days{numSelection.value()});
             SimTimeManager::updateAll();
 
@@ -99,7 +151,20 @@ void ConsoleInterface::run() {
             accountAction = accountMenu(*selected);
             handleAccountAction(accountAction, *selected);
             break;
+
+        case ExportStatements:
+            exportAllStatements();
+            break;
+
         case Quit:
+            if (snapshotPath_) {
+                const auto journalSequence = journal_->lastSequence();
+                // writeSnapshot has synced the snapshot and its directory by the time it returns, so only then is it
+                // safe to drop the journaled records it includes
+                writeSnapshot(*snapshotPath_, openAccounts_, journalSequence);
+                journal_->checkpoint(journalSequence);
+                successMsg("Saved {} accounts to {}", openAccounts_.size(), snapshotPath_->string());
+            }
             return;
         }
     }
@@ -114,11 +179,12 @@ ConsoleInterface::MainMenuOption ConsoleInterface::mainMenu() {
                   << "\n\t1) New Account"
                   << "\n\t2) Simulate Time"
                   << "\n\t3) Account Actions"
-                  << "\n\t4) Quit"
-                  << "\n[1-4]: ";
+                  << "\n\t4) Export Statements"
+                  << "\n\t5) Quit"
+                  << "\n[1-5]: ";
 
         selection = getIntInput();
-        auto inRangeFn = [](int val) { return val > 0 && val < 5; };
+        auto inRangeFn = [](int val) { return val > 0 && val < 6; };
 
         if (!selection.has_value() || !inRangeFn(selection.value())) {
             errorMsg("Invalid option!");
@@ -166,13 +232,18 @@ void ConsoleInterface::handleAccountAction(AccountMenuOption opt, BankAccount& a
 
     if (opt == Close) {
         successMsg("Successfully closed account.");
-        std::erase_if(openAccounts_, [&](auto& acc) { return account.getAccountNumber() == acc.getAccountNumber(); });
+        if (journal_) {
+            journal_->recordClosed(account.getAccountNumber());
+        }
+        openAccounts_.close(account.getAccountNumber());
         return;
     }
 
     if (opt == DisplayStatement) {
         successMsg("Account statements below:\n");
-        fmt::println("{}", fmt::join(account.getAllMonthlyStatements(), "\n\n"));
+        statementRenderer_.clear();
+        statementRenderer_.renderAll(account);
+        fmt::println("{}", statementRenderer_.view());
         return;
     }
 
@@ -188,35 +259,47 @@ void ConsoleInterface::handleAccountAction(AccountMenuOption opt, BankAccount& a
         return;
     }
 
-    std::optional<int> selectedAmount;
+    std::optional<Money> selectedAmount;
     if (opt == Deposit || opt == Withdraw) {
         std::cout << "Please specify an amount (USD): ";
-        selectedAmount = getIntInput();
+        selectedAmount = getMoneyInput();
     } else {
         errorMsg("Internal error; invalid option.");
         return;
     }
 
     if (!selectedAmount.has_value()) {
-        errorMsg("Invalid input! Must be integral.");
+        errorMsg("Invalid input! Must be an amount such as $1,234.56.");
         return;
     }
 
+    const Transaction transaction{.type = opt == Deposit ? Transaction::Type::Deposit : Transaction::Type::Withdrawal,
+                                  .amount = selectedAmount.value()};
+    if (journal_) {
+        journal_->record(account.getAccountNumber(), transaction);
+    }
+
     if (opt == Deposit) {
-        successMsg("Deposited ${}.", selectedAmount.value());
-        account.deposit(Money{selectedAmount.value(), 0});
+        successMsg("Deposited {}.", selectedAmount.value());
+        account.deposit(transaction.amount);
     } else {
-        successMsg("Withdrew ${}.", selectedAmount.value());
-        account.withdraw(Money{selectedAmount.value(), 0});
+        successMsg("Withdrew {}.", selectedAmount.value());
+        account.withdraw(transaction.amount);
     }
 }
 
 BankAccount* ConsoleInterface::selectAccount() {
-    std::vector<int> accountIds;
-    std::transform(openAccounts_.begin(), openAccounts_.end(), std::back_inserter(accountIds),
-                   [](const auto& acc) { return acc.getAccountNumber(); });
-
-    fmt::print("Please choose an account number from the following: [{}]\nid: ", fmt::join(accountIds, ", "));
+    // Listing every account is only helpful while there are few of them
+    constexpr std::size_t MAX_LISTED = 20;
+
+    if (openAccounts_.size() <= MAX_LISTED) {
+        std::vector<int> accountIds;
+        std::transform(openAccounts_.begin(), openAccounts_.end(), std::back_inserter(accountIds),
+                       [](const auto& acc) { return acc.getAccountNumber(); });
+        fmt::print("Please choose an account number from the following: [{}]\nid: ", fmt::join(accountIds, ", "));
+    } else {
+        fmt::print("Please choose one of the {} open account numbers\nid: ", openAccounts_.size());
+    }
 
     auto choice = getIntInput();
 
@@ -225,10 +308,8 @@ BankAccount* ConsoleInterface::selectAccount() {
         return nullptr;
     }
 
-    if (auto iter = std::find(accountIds.begin(), accountIds.end(), choice); iter != accountIds.end()) {
-        // The index of each corresponding id will remain the same
-        auto idx = static_cast<std::size_t>(std::distance(accountIds.begin(), iter));
-        return &openAccounts_[idx];
+    if (auto* account = openAccounts_.find(choice.value())) {
+        return account;
     }
 
     errorMsg("Account id does not exist!");
@@ -266,27 +347,28 @@ void ConsoleInterface::newAccount() {
         return holderNames.at(static_cast<std::size_t>(distr(gen)));
     }()};
 
+    BankAccount* opened = nullptr;
     switch (selection.value()) {
     case 1:
-        openAccounts_.emplace_back(CertificateOfDepositAccount(name, startingBalance, maturityMonths,
-                                                               WITHDRAWAL_PENALTY, defaultInterest, SimTimeManager{}));
+        opened = &openAccounts_.insert(CertificateOfDepositAccount(
+            name, startingBalance, maturityMonths, WITHDRAWAL_PENALTY, defaultInterest, SimTimeManager{}));
         break;
     case 2:
-        openAccounts_.emplace_back(
+        opened = &openAccounts_.insert(
             NoServiceChargeCheckingAccount(name, startingBalance, defaultInterest, SimTimeManager{}));
         break;
     case 3:
-        openAccounts_.emplace_back(ServiceChargeCheckingAccount(name, startingBalance, SimTimeManager{}));
+        opened = &openAccounts_.insert(ServiceChargeCheckingAccount(name, startingBalance, SimTimeManager{}));
         break;
     case 4:
-        openAccounts_.emplace_back(
+        opened = &openAccounts_.insert(
             HighInterestCheckingAccount(name, startingBalance, defaultInterest, SimTimeManager{}));
         break;
     case 5:
-        openAccounts_.emplace_back(SavingsAccount(name, startingBalance, defaultInterest, SimTimeManager{}));
+        opened = &openAccounts_.insert(SavingsAccount(name, startingBalance, defaultInterest, SimTimeManager{}));
         break;
     case 6:
-        openAccounts_.emplace_back(
+        opened = &openAccounts_.insert(
             HighInterestSavingsAccount(name, startingBalance, defaultInterest, SimTimeManager{}));
         break;
 
@@ -295,4 +377,26 @@ void ConsoleInterface::newAccount() {
         assert(false);
         break;
     }
+
+    if (journal_ && opened != nullptr) {
+        journal_->recordOpened(*opened);
+    }
+}
+
+void ConsoleInterface::exportAllStatements() const {
+    std::cout << "Enter the file to write every account's statements to: ";
+    std::string path;
+    std::getline(std::cin, path);
+    if (path.empty()) {
+        errorMsg("No file given!");
+        return;
+    }
+
+    try {
+        exportStatements(path, openAccounts_);
+    } catch (const std::runtime_error& error) {
+        errorMsg("{}", error.what());
+        return;
+    }
+    successMsg("Wrote statements of {} accounts to {}", openAccounts_.size(), path);
 }
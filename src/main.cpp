@@ -1,9 +1,82 @@
+#include "account_store.h"
+#include "bank_account.h"
+#include "batch_runner.h"
 #include "console_interface.h"
+#include "statement_archive.h"
 
-int main() {
-    ConsoleInterface cli{};
+#include <fmt/core.h>
 
-    cli.run();
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+//! Runs the script at `path`, or from stdin without one, returning 1 if any of its commands failed
+int runBatch(std::optional<std::string_view> path) {
+    AccountStore<BankAccount> accounts;
+    BatchRunner runner{accounts, std::cout};
+    if (!path || *path == "-") {
+        return runner.run(std::cin) == 0 ? 0 : 1;
+    }
+
+    std::ifstream script{std::string{*path}, std::ios::binary};
+    if (!script) {
+        throw std::runtime_error(fmt::format("Failed to open {}", *path));
+    }
+    return runner.run(script) == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::optional<std::string_view> snapshotPath;
+    std::optional<std::string_view> archivePath;
+    // Batch mode reads from stdin unless given a file
+    std::optional<std::string_view> batchPath;
+    bool batch = false;
+    const std::span args{argv + 1, static_cast<std::size_t>(argc - 1)};
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        if (std::string_view{args[i]} == "--snapshot" && i + 1 < args.size()) {
+            snapshotPath = args[++i];
+        } else if (std::string_view{args[i]} == "--archive" && i + 1 < args.size()) {
+            archivePath = args[++i];
+        } else if (std::string_view{args[i]} == "--batch") {
+            batch = true;
+            if (i + 1 < args.size() && !std::string_view{args[i + 1]}.starts_with("--")) {
+                batchPath = args[++i];
+            }
+        } else {
+            fmt::println(stderr, "Usage: {} [--snapshot <file> | --batch [<file>]] [--archive <file>]", argv[0]);
+            return 1;
+        }
+    }
+    if (batch && snapshotPath) {
+        fmt::println(stderr, "--batch cannot be combined with --snapshot");
+        return 1;
+    }
+
+    try {
+        if (archivePath) {
+            StatementArchive::setActive(std::make_shared<StatementArchive>(*archivePath));
+        }
+        if (batch) {
+            return runBatch(batchPath);
+        }
+
+        ConsoleInterface cli = snapshotPath ? ConsoleInterface{*snapshotPath} : ConsoleInterface{};
+        cli.run();
+    } catch (const std::exception& error) {
+        fmt::println(stderr, "Error: {}", error.what());
+        return 1;
+    }
 
     return 0;
 }
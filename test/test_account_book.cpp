@@ -0,0 +1,66 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "account_book.h"
+#include "interest_handler.h"
+#include "util/date_util.h"
+
+TEST_CASE("Account book", "[account]") {
+    SimTimeManager::resetDay();
+    const InterestHandler noInterestHandler(InterestType::Daily, 0.00);
+
+    AccountBook book;
+    std::vector<int> numbers;
+    for (int i = 0; i < 5; ++i) {
+        const Money balance{1000 * (i + 1), 0};
+        numbers.push_back(book.insert(SavingsAccount("savings", balance, noInterestHandler, SimTimeManager{}))
+                              .getAccountNumber());
+        numbers.push_back(
+            book.insert(ServiceChargeCheckingAccount("sc_checking", balance, SimTimeManager{})).getAccountNumber());
+    }
+
+    auto storedNumbers = [&] {
+        std::vector<int> result;
+        book.forEach([&](const auto& account) { result.push_back(account.getAccountNumber()); });
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    SECTION("per-type arrays") {
+        CHECK(book.size() == 10);
+        CHECK(book.accounts<SavingsAccount>().size() == 5);
+        CHECK(book.accounts<ServiceChargeCheckingAccount>().size() == 5);
+        CHECK(book.accounts<CertificateOfDepositAccount>().empty());
+        CHECK(storedNumbers() == numbers);
+    }
+
+    SECTION("visit by account number") {
+        std::string_view name;
+        CHECK(book.visit(numbers[3], [&](auto& account) {
+            account.deposit(1_dollars);
+            name = account.getAccountName();
+        }));
+        CHECK(name == "sc_checking");
+        CHECK(std::get<ServiceChargeCheckingAccount*>(*book.find(numbers[3]))->getBalance() == 2'001_dollars);
+        CHECK_FALSE(book.visit(-1, [](const auto& /*account*/) {}));
+    }
+
+    SECTION("closing accounts") {
+        CHECK(book.close(numbers[0]));
+        CHECK_FALSE(book.close(numbers[0]));
+        CHECK_FALSE(book.find(numbers[0]));
+        numbers.erase(numbers.begin());
+        CHECK(storedNumbers() == numbers);
+
+        // The last savings account took the closed one's place, and is still found and updated
+        const auto* moved = std::get<SavingsAccount*>(*book.find(numbers[7]));
+        CHECK(moved == book.accounts<SavingsAccount>().data());
+        CHECK(moved->getBalance() == 5'000_dollars);
+        SimTimeManager::incrDay(std::chrono::days{32});
+        SimTimeManager::updateAll();
+        CHECK_FALSE(moved->getAllMonthlyStatements().empty());
+    }
+}
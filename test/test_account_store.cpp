@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "interest_handler.h"
+#include "savings_account.h"
+#include "util/date_util.h"
+
+TEST_CASE("Account store", "[account]") {
+    SimTimeManager::resetDay();
+    const InterestHandler noInterestHandler(InterestType::Daily, 0.00);
+
+    AccountStore<BankAccount> store;
+    std::vector<int> numbers;
+    for (int i = 0; i < 10; ++i) {
+        auto& account = store.insert(SavingsAccount("savings", Money{i, 0}, noInterestHandler, SimTimeManager{}));
+        numbers.push_back(account.getAccountNumber());
+    }
+
+    auto storedNumbers = [&] {
+        std::vector<int> result;
+        for (const auto& account : store) {
+            result.push_back(account.getAccountNumber());
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    SECTION("lookup by account number") {
+        REQUIRE(store.size() == 10);
+        for (int i = 0; i < 10; ++i) {
+            const auto* account = store.find(numbers[static_cast<std::size_t>(i)]);
+            REQUIRE(account != nullptr);
+            CHECK(account->getBalance() == Money{i, 0});
+        }
+        CHECK(store.find(-1) == nullptr);
+    }
+
+    SECTION("closing accounts") {
+        CHECK(store.close(numbers[3]));
+        CHECK_FALSE(store.close(numbers[3]));
+        CHECK(store.find(numbers[3]) == nullptr);
+        CHECK(store.size() == 9);
+
+        numbers.erase(numbers.begin() + 3);
+        CHECK(storedNumbers() == numbers);
+    }
+
+    SECTION("references stay valid") {
+        auto* first = store.find(numbers[0]);
+        store.close(numbers[5]);
+        for (int i = 0; i < 1000; ++i) {
+            store.insert(SavingsAccount("savings", 1_dollars, noInterestHandler, SimTimeManager{}));
+        }
+        CHECK(store.find(numbers[0]) == first);
+        CHECK(store.size() == 1009);
+    }
+}
@@ -1,6 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <fmt/core.h>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "bank_account.h"
 #include "cd_account.h"
@@ -10,6 +16,7 @@
 #include "nosc_checking_account.h"
 #include "savings_account.h"
 #include "sc_checking_account.h"
+#include "transaction.h"
 #include "util/date_util.h"
 
 // To reduce syntax noise
@@ -121,6 +128,34 @@ TEST_CASE("Interest tests", "[account]") {
         CAPTURE(std::string(savings.getBalance()), std::string(newBalance));
         CHECK(savings.getBalance() == newBalance);
     }
+
+    SECTION("Monthly interest payout schedule") {
+        const InterestHandler monthlyInterestHandler(InterestType::Monthly, 0.01);
+        SavingsAccount savings("savings", startingBalance, monthlyInterestHandler, SimTimeManager{});
+
+        auto num_records = [&] {
+            std::size_t num = 0;
+            for (const auto& statement : savings.getAllMonthlyStatements()) {
+                num += statement.records.size();
+            }
+            return num;
+        };
+
+        // Payouts are a full (average) month apart, so stepping a day at a time or all at once must agree
+        SECTION("single step") {
+            SimTimeManager::incrDay(std::chrono::days{366});
+            SimTimeManager::updateAll();
+        }
+        SECTION("daily steps") {
+            repeat(366) {
+                SimTimeManager::incrDay();
+                SimTimeManager::updateAll();
+            }
+        }
+
+        // Account creation record + 11 payouts
+        CHECK(num_records() == 12);
+    }
 }
 
 TEST_CASE("Service charge tests", "[account]") {
@@ -194,4 +229,261 @@ TEST_CASE("Monthly records tests", "[account]") {
 
         CHECK(num_records(simple) == 1224);
     }
+
+    SECTION("idle months") {
+        // Below the minimum balance, so no interest records are made
+        HighInterestSavingsAccount simple("simple", 1_dollars, noInterestHandler, SimTimeManager{});
+        const auto opened = SimTimeManager::getDate();
+
+        // A single update spanning decades
+        SimTimeManager::incrDay(std::chrono::days{365 * 30});
+        SimTimeManager::updateAll();
+
+        const auto statements = simple.getAllMonthlyStatements();
+        CHECK(static_cast<std::int64_t>(statements.size()) ==
+              Date::monthsBetween(opened, SimTimeManager::getDate()) + 1);
+
+        std::size_t numMonths = 0;
+        Date expectedStart = opened.monthStart();
+        for (const auto& statement : statements) {
+            CHECK(statement.start == expectedStart);
+            CHECK(statement.complete == (numMonths + 1 != statements.size()));
+            expectedStart = statement.end + std::chrono::days{1};
+            ++numMonths;
+        }
+        CHECK(numMonths == statements.size());
+
+        const auto idle = simple.getMonthlyStatement(opened + std::chrono::days{365 * 10});
+        CHECK(idle.records.empty());
+        CHECK(idle.complete);
+        CHECK_THROWS(simple.getMonthlyStatement(SimTimeManager::getDate() + std::chrono::days{31}));
+    }
+
+    SECTION("copies share history") {
+        NoServiceChargeCheckingAccount original("original", startingBalance, noInterestHandler, SimTimeManager{});
+        SimTimeManager::incrDay(std::chrono::days{400});
+        SimTimeManager::updateAll();
+        const auto lastMonth = SimTimeManager::getDate();
+        const auto numRecords = num_records(original);
+
+        const auto firstMonth = original.getMonthlyStatement(original.getAccountOpeningDate());
+        auto copy = original;
+        CHECK(&*copy.getAllMonthlyStatements().begin() == &*original.getAllMonthlyStatements().begin());
+
+        copy.deposit(1_dollars);
+        SimTimeManager::incrDay(std::chrono::days{40});
+        SimTimeManager::updateAll();
+
+        // Both moved on independently from where they were copied
+        CHECK(num_records(copy) == num_records(original) + 1);
+        CHECK(original.getMonthlyStatement(lastMonth).records.size() + 1 ==
+              copy.getMonthlyStatement(lastMonth).records.size());
+        CHECK(num_records(original) > numRecords);
+        CHECK(copy.getMonthlyStatement(copy.getAccountOpeningDate()).records.size() == firstMonth.records.size());
+    }
+
+    SECTION("record ordering") {
+        using namespace std::chrono;
+        const auto record = [](int id) {
+            return StatementRecordInfo{.event = StatementRecordInfo::Event::Deposit,
+                                       .amount = Money{id, 0},
+                                       .balanceChange = 0_dollars,
+                                       .changeType = StatementRecordInfo::None,
+                                       .resultantBalance = 0_dollars};
+        };
+        StatementRecords records;
+        records.emplace(Date{2024y / March / 2}, record(0));
+        records.emplace(Date{2024y / March / 5}, record(1));
+        records.emplace(Date{2024y / March / 2}, record(2));
+        records.emplace(Date{2024y / March / 1}, record(3));
+
+        // Same dates keep the order they were added in, as with std::multimap
+        std::vector<std::uint64_t> order;
+        for (const auto& [date, rec] : records) {
+            order.push_back(rec.amount.dollars());
+        }
+        CHECK(order == std::vector<std::uint64_t>{3, 0, 2, 1});
+
+        auto [first, last] = records.equal_range(Date{2024y / March / 2});
+        CHECK(std::distance(first, last) == 2);
+        CHECK(records.equal_range(Date{2024y / March / 3}).first->second.amount == 1_dollars);
+    }
+    SECTION("record descriptions") {
+        NoServiceChargeCheckingAccount simple("simple", 1000_dollars, noInterestHandler, SimTimeManager{});
+        simple.withdraw(600_dollars);
+        simple.writeCheck(600_dollars);
+        simple.withdraw(300_dollars);
+        simple.withdraw(300_dollars);
+
+        const auto statement = simple.getMonthlyStatement(SimTimeManager::getDate());
+        const auto& records = statement.records;
+        REQUIRE(records.size() == 5);
+
+        std::vector<std::string> details;
+        for (const auto& [date, rec] : records) {
+            details.push_back(fmt::format("{}", rec));
+        }
+        CHECK(details[0].starts_with("Account opened "));
+        CHECK(details[1].starts_with("Successful withdrawal "));
+        CHECK(details[2].starts_with("check failure ($600.00). Would place account below minimum of $100.00."));
+        CHECK(details[3].starts_with("Successful withdrawal "));
+        CHECK(details[4].starts_with("withdrawal failure ($300.00). "
+                                     "Account balance already at or below minimum of $100.00."));
+    }
+}
+
+TEST_CASE("Parallel updates", "[account]") {
+    const InterestHandler dailyInterestHandler(InterestType::Daily, 0.0001);
+    const InterestHandler monthlyInterestHandler(InterestType::Monthly, 0.01);
+
+    auto simulate = [&](std::size_t numThreads) {
+        SimTimeManager::resetDay();
+        SimTimeManager::setUpdateThreads(numThreads);
+
+        std::vector<BankAccount> accounts;
+        for (int i = 0; i < 50; ++i) {
+            const Money balance{1000 * (i + 1), 0};
+            accounts.emplace_back(SavingsAccount("savings", balance, monthlyInterestHandler, SimTimeManager{}));
+            accounts.emplace_back(CertificateOfDepositAccount("cd", balance, std::chrono::months{12}, 0.1,
+                                                              dailyInterestHandler, SimTimeManager{}));
+            accounts.emplace_back(HighInterestCheckingAccount("hi_checking", balance, dailyInterestHandler,
+                                                              SimTimeManager{}));
+            accounts.emplace_back(ServiceChargeCheckingAccount("sc_checking", balance, SimTimeManager{}));
+        }
+
+        repeat(400) {
+            SimTimeManager::incrDay();
+            SimTimeManager::updateAll();
+            accounts[static_cast<std::size_t>(i) % accounts.size()].withdraw(500_dollars);
+        }
+        SimTimeManager::setUpdateThreads(1);
+
+        std::vector<std::string> statements;
+        for (const auto& account : accounts) {
+            for (const auto& statement : account.getAllMonthlyStatements()) {
+                statements.push_back(fmt::format("{}", statement));
+            }
+        }
+        return statements;
+    };
+
+    const auto serial = simulate(1);
+    const auto parallel = simulate(4);
+    REQUIRE(serial.size() == parallel.size());
+    CHECK(serial == parallel);
+}
+
+TEST_CASE("Type-erased account storage", "[account]") {
+    STATIC_CHECK(BankAccount::storedInline<SavingsAccount>());
+    STATIC_CHECK(BankAccount::storedInline<HighInterestSavingsAccount>());
+    STATIC_CHECK(BankAccount::storedInline<CertificateOfDepositAccount>());
+    STATIC_CHECK(BankAccount::storedInline<ServiceChargeCheckingAccount>());
+    STATIC_CHECK(BankAccount::storedInline<NoServiceChargeCheckingAccount>());
+    STATIC_CHECK(BankAccount::storedInline<HighInterestCheckingAccount>());
+    STATIC_CHECK(CheckingAccount::storedInline<ServiceChargeCheckingAccount>());
+    STATIC_CHECK(CheckingAccount::storedInline<NoServiceChargeCheckingAccount>());
+    STATIC_CHECK(CheckingAccount::storedInline<HighInterestCheckingAccount>());
+
+    SimTimeManager::resetDay();
+    const InterestHandler interestHandler(InterestType::Daily, 0.0);
+
+    SECTION("copies are independent") {
+        BankAccount original = SavingsAccount("savings", 100_dollars, interestHandler, SimTimeManager{});
+        BankAccount other = ServiceChargeCheckingAccount("sc_checking", 500_dollars, SimTimeManager{});
+
+        other = original;
+        other.deposit(50_dollars);
+        CHECK(original.getBalance() == 100_dollars);
+        CHECK(other.getBalance() == 150_dollars);
+        CHECK(other.getAccountName() == original.getAccountName());
+    }
+
+    SECTION("moved accounts keep receiving updates") {
+        CheckingAccount first = ServiceChargeCheckingAccount("sc_checking", 500_dollars, SimTimeManager{});
+        CheckingAccount second = first;
+        std::vector<CheckingAccount> accounts;
+        accounts.push_back(std::move(first));
+        accounts.push_back(std::move(second));
+        accounts.emplace_back(accounts.front());
+
+        SimTimeManager::incrDay(std::chrono::days{32});
+        SimTimeManager::updateAll();
+        for (auto& account : accounts) {
+            account.writeCheck(10_dollars);
+            CHECK(account.getBalance() == 500_dollars - ServiceChargeCheckingAccount::SERVICE_CHARGE - 10_dollars);
+        }
+    }
+}
+
+TEST_CASE("Batch transactions", "[account]") {
+    SimTimeManager::resetDay();
+    const InterestHandler interestHandler(InterestType::Daily, 0.0001);
+    using Type = Transaction::Type;
+
+    std::vector<Transaction> batch;
+    for (int i = 0; i < 40; ++i) {
+        batch.push_back({Type::Deposit, Money{50 * i, 25}});
+        batch.push_back({Type::Withdrawal, Money{80 * i, 0}});
+        if (i % 3 == 0) {
+            batch.push_back({Type::Check, Money{30 * i, 99}});
+        }
+    }
+
+    // Applies the batch to one copy and the same operations one at a time to another, which must end up identical
+    auto checkSameAsSingle = [&](auto account, const std::vector<Transaction>& transactions) {
+        auto single = account;
+        SimTimeManager::incrDay(std::chrono::days{45});
+        SimTimeManager::updateAll();
+
+        std::size_t numSucceeded = 0;
+        for (const auto& transaction : transactions) {
+            const auto balance = single.getBalance();
+            switch (transaction.type) {
+            case Type::Deposit:
+                single.deposit(transaction.amount);
+                break;
+            case Type::Withdrawal:
+                single.withdraw(transaction.amount);
+                break;
+            case Type::Check:
+                if constexpr (requires { single.writeCheck(Money{}); }) {
+                    single.writeCheck(transaction.amount);
+                }
+                break;
+            }
+            numSucceeded += single.getBalance() != balance || transaction.amount == 0_dollars ? 1 : 0;
+        }
+
+        CHECK(account.apply(transactions) == numSucceeded);
+        CHECK(account.getBalance() == single.getBalance());
+        CHECK(fmt::format("{}", account.getMonthlyStatement(SimTimeManager::getDate())) ==
+              fmt::format("{}", single.getMonthlyStatement(SimTimeManager::getDate())));
+    };
+
+    std::vector<Transaction> noChecks;
+    std::copy_if(batch.begin(), batch.end(), std::back_inserter(noChecks),
+                 [](const auto& txn) { return txn.type != Type::Check; });
+
+    checkSameAsSingle(SavingsAccount("savings", 20'000_dollars, interestHandler, SimTimeManager{}), noChecks);
+    checkSameAsSingle(HighInterestSavingsAccount("hi_savings", 20'000_dollars, interestHandler, SimTimeManager{}),
+                      noChecks);
+    checkSameAsSingle(CertificateOfDepositAccount("cd", 20'000_dollars, std::chrono::months{1}, 0.1, interestHandler,
+                                                  SimTimeManager{}),
+                      noChecks);
+    checkSameAsSingle(ServiceChargeCheckingAccount("sc_checking", 20'000_dollars, SimTimeManager{}), batch);
+    checkSameAsSingle(
+        NoServiceChargeCheckingAccount("nosc_checking", 20'000_dollars, interestHandler, SimTimeManager{}), batch);
+    checkSameAsSingle(HighInterestCheckingAccount("hi_checking", 20'000_dollars, interestHandler, SimTimeManager{}),
+                      batch);
+    checkSameAsSingle(BankAccount{ServiceChargeCheckingAccount("sc_checking", 20'000_dollars, SimTimeManager{})},
+                      noChecks);
+    checkSameAsSingle(CheckingAccount{HighInterestCheckingAccount("hi_checking", 20'000_dollars, interestHandler,
+                                                                  SimTimeManager{})},
+                      batch);
+
+    SECTION("checks need a checking account") {
+        BankAccount savings = SavingsAccount("savings", 20'000_dollars, interestHandler, SimTimeManager{});
+        CHECK_THROWS_AS(savings.apply(batch), std::invalid_argument);
+        CHECK(savings.getBalance() == 20'000_dollars);
+    }
 }
@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "batch_runner.h"
+#include "statement_renderer.h"
+#include "util/date_util.h"
+
+TEST_CASE("Batch runner", "[account]") {
+    SimTimeManager::resetDay();
+    const auto start = SimTimeManager::getDate();
+    AccountStore<BankAccount> accounts;
+    std::ostringstream output;
+
+    SECTION("runs commands against accounts") {
+        BatchRunner runner{accounts, output};
+        const auto numFailed = runner.run("# Opening accounts\n"
+                                          "open sav savings \"Sav Ings\" 3000 0.0\n"
+                                          "open chk checking Chk \"$1,000.00\" 0.0\r\n"
+                                          "\n"
+                                          "  deposit sav 10.50\n"
+                                          "withdraw chk 20\n"
+                                          "check chk 2000\n"
+                                          "check sav 1\n"
+                                          "step 3\n"
+                                          "refund sav 1\n"
+                                          "deposit sav 1.2.3\n"
+                                          "open sav savings Again 1 0.0\n");
+        CHECK(numFailed == 4);
+        REQUIRE(accounts.size() == 2);
+        CHECK(SimTimeManager::getDate() == start + std::chrono::days{3});
+
+        const auto& savings = *accounts.begin();
+        const auto& checking = *std::next(accounts.begin());
+        CHECK(savings.getBalance() == 3'010.50_dollars);
+        CHECK(checking.getBalance() == 980_dollars);
+
+        const auto text = output.str();
+        CHECK(text.find(fmt::format("{}: opened savings for \"Sav Ings\" as sav\n", savings.getAccountNumber())) == 0);
+        CHECK(text.find(fmt::format("{}: check $2,000.00 declined, balance $980.00\n", checking.getAccountNumber())) !=
+              std::string::npos);
+        CHECK(text.find("Error on line 8: ") != std::string::npos);
+        CHECK(text.find("Error on line 10: Unknown command 'refund'\n") != std::string::npos);
+        CHECK(text.find("Error on line 11: Invalid amount '1.2.3'\n") != std::string::npos);
+        CHECK(text.find("Error on line 12: Alias 'sav' is already in use\n") != std::string::npos);
+
+        // Accounts are also found by number, until they are closed
+        output.str("");
+        CHECK(runner.run(fmt::format("close {}\ninfo sav\n", savings.getAccountNumber())) == 1);
+        CHECK(accounts.size() == 1);
+    }
+
+    SECTION("closing an account frees its alias") {
+        BatchRunner runner{accounts, output};
+        const auto numFailed = runner.run("open acct savings First 100 0.0\n"
+                                          "close acct\n"
+                                          "deposit acct 5\n"
+                                          "open acct checking Second 200 0.0\n"
+                                          "withdraw acct 20\n");
+        CHECK(numFailed == 1);
+        REQUIRE(accounts.size() == 1);
+        CHECK(accounts.begin()->getAccountName() == "Second");
+        CHECK(accounts.begin()->getBalance() == 180_dollars);
+        CHECK(output.str().find("Error on line 3: Unknown account 'acct'\n") != std::string::npos);
+    }
+
+    SECTION("statements match rendering them") {
+        BatchRunner runner{accounts, output};
+        REQUIRE(runner.run("open sc sc-checking Someone 500\nstep 40\nwithdraw sc 5\nstatement sc\n") == 0);
+
+        StatementRenderer renderer;
+        renderer.renderAll(*accounts.begin());
+        CHECK(output.str().ends_with(fmt::format("{}\n\n", renderer.view())));
+    }
+
+    SECTION("output is the same with a small buffer") {
+        BatchRunner{accounts, output}.run("open a cd A 15000 0.05 6 0.2\nstep 31\n");
+        output.str("");
+
+        // Once accounts have been opened, they are found by number
+        const auto number = accounts.begin()->getAccountNumber();
+        BatchRunner runner{accounts, output};
+        runner.run(fmt::format("info {0}\nstatement {0}\n", number));
+        std::ostringstream smallOutput;
+        BatchRunner smallRunner{accounts, smallOutput, 16};
+        smallRunner.run(fmt::format("info {0}\nstatement {0}\n", number));
+        CHECK(smallOutput.str() == output.str());
+    }
+}
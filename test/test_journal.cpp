@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "cd_account.h"
+#include "interest_handler.h"
+#include "journal.h"
+#include "savings_account.h"
+#include "sc_checking_account.h"
+#include "snapshot.h"
+#include "transaction.h"
+#include "util/date_util.h"
+
+namespace {
+
+std::string describe(const BankAccount& account) {
+    std::string description = fmt::format("{} {} {:%D} {}\n", account.getAccountNumber(), account.getAccountName(),
+                                          account.getAccountOpeningDate(), account.getBalance());
+    for (const auto& statement : account.getAllMonthlyStatements()) {
+        description += fmt::format("{}", statement);
+    }
+    return description;
+}
+
+void journaled(Journal& journal, BankAccount& account, Transaction transaction) {
+    journal.record(account.getAccountNumber(), transaction);
+    account.apply(std::span{&transaction, 1});
+}
+
+void journaledStep(Journal& journal, std::chrono::days days) {
+    journal.recordTimeStep(days);
+    SimTimeManager::incrDay(days);
+    SimTimeManager::updateAll();
+}
+
+} // namespace
+
+TEST_CASE("Journal", "[account]") {
+    using Type = Transaction::Type;
+
+    SimTimeManager::resetDay();
+    const InterestHandler monthly(InterestType::Monthly, 0.01);
+    const auto snapshotPath = std::filesystem::temp_directory_path() / "bank_accounts_test_journal_snapshot.bin";
+    const auto journalPath = std::filesystem::temp_directory_path() / "bank_accounts_test_journal.bin";
+    std::filesystem::remove(snapshotPath);
+    std::filesystem::remove(journalPath);
+
+    SECTION("replayed on top of the last snapshot") {
+        std::map<int, std::string> expected;
+        std::uint64_t snapshotSequence = 0;
+        {
+            AccountStore<BankAccount> accounts;
+            Journal journal{journalPath};
+            CHECK(journal.replay(accounts) == 0);
+
+            auto& savings = accounts.insert(SavingsAccount("Sav Ings", 3'000_dollars, monthly, SimTimeManager{}));
+            journal.recordOpened(savings);
+            auto& checking = accounts.insert(ServiceChargeCheckingAccount("Check Ing", 1'000_dollars, SimTimeManager{}));
+            journal.recordOpened(checking);
+
+            for (int day = 0; day < 40; ++day) {
+                journaled(journal, savings, {Type::Deposit, Money{day, 0}});
+                journaled(journal, checking, {Type::Check, Money{day, 25}});
+                journaledStep(journal, std::chrono::days{1});
+            }
+
+            // Left in the journal, as if the program stopped before emptying it
+            snapshotSequence = journal.lastSequence();
+            writeSnapshot(snapshotPath, accounts, snapshotSequence);
+
+            for (int day = 0; day < 40; ++day) {
+                journaled(journal, savings, {Type::Withdrawal, Money{day, 50}});
+                journaled(journal, checking, {Type::Deposit, Money{2 * day, 0}});
+                journaledStep(journal, std::chrono::days{2});
+            }
+            auto& cd = accounts.insert(CertificateOfDepositAccount("Cee Dee", 5'000_dollars, std::chrono::months{6},
+                                                                   0.1, monthly, SimTimeManager{}));
+            journal.recordOpened(cd);
+            journaledStep(journal, std::chrono::days{200});
+            journaled(journal, cd, {Type::Withdrawal, 100_dollars});
+            journal.recordClosed(checking.getAccountNumber());
+            accounts.close(checking.getAccountNumber());
+
+            for (const auto& account : accounts) {
+                expected.emplace(account.getAccountNumber(), describe(account));
+            }
+        }
+
+        const Snapshot snapshot{snapshotPath};
+        CHECK(snapshot.journalSequence() == snapshotSequence);
+        AccountStore<BankAccount> restored;
+        snapshot.loadInto(restored);
+
+        Journal journal{journalPath};
+        CHECK(journal.lastSequence() == snapshotSequence + 40 * 3 + 4);
+        CHECK(journal.replay(restored, snapshot.journalSequence()) == 40 * 3 + 4);
+
+        REQUIRE(restored.size() == expected.size());
+        for (const auto& [number, description] : expected) {
+            const auto* account = restored.find(number);
+            REQUIRE(account != nullptr);
+            CHECK(describe(*account) == description);
+        }
+    }
+
+    SECTION("checkpoints empty the journal, but keep numbering records after it") {
+        Journal journal{journalPath};
+        SavingsAccount account("Sav Ings", 3'000_dollars, monthly, SimTimeManager{});
+        journal.record(account.getAccountNumber(), {Type::Deposit, 1_dollars});
+        journal.record(account.getAccountNumber(), {Type::Deposit, 2_dollars});
+
+        const auto sequence = journal.lastSequence();
+        CHECK(journal.checkpoint(sequence));
+        CHECK(std::filesystem::file_size(journalPath) < 32);
+
+        journal.record(account.getAccountNumber(), {Type::Deposit, 3_dollars});
+        CHECK(journal.lastSequence() == sequence + 1);
+        CHECK_FALSE(journal.checkpoint(sequence));
+        journal.sync();
+        CHECK(std::filesystem::file_size(journalPath) > 32);
+    }
+
+    SECTION("emptied only once the snapshot including it is written, as on quitting") {
+        AccountStore<BankAccount> accounts;
+        Journal journal{journalPath};
+        auto& savings = accounts.insert(SavingsAccount("Sav Ings", 3'000_dollars, monthly, SimTimeManager{}));
+        journal.recordOpened(savings);
+        journaled(journal, savings, {Type::Deposit, 5_dollars});
+        const auto sequence = journal.lastSequence();
+
+        // The checkpoint is never reached if writing the snapshot throws, so the records are kept
+        CHECK_THROWS_AS(writeSnapshot(snapshotPath / "missing", accounts, sequence), std::runtime_error);
+        journal.sync();
+        CHECK(std::filesystem::file_size(journalPath) > 32);
+
+        writeSnapshot(snapshotPath, accounts, sequence);
+        CHECK(journal.checkpoint(sequence));
+
+        const Snapshot snapshot{snapshotPath};
+        AccountStore<BankAccount> restored;
+        snapshot.loadInto(restored);
+        CHECK(journal.replay(restored, snapshot.journalSequence()) == 0);
+        REQUIRE(restored.find(savings.getAccountNumber()) != nullptr);
+        CHECK(describe(*restored.find(savings.getAccountNumber())) == describe(savings));
+    }
+
+    SECTION("a torn last record is dropped") {
+        SavingsAccount account("Sav Ings", 3'000_dollars, monthly, SimTimeManager{});
+        {
+            Journal journal{journalPath};
+            journal.record(account.getAccountNumber(), {Type::Deposit, 1_dollars});
+            journal.record(account.getAccountNumber(), {Type::Deposit, 2_dollars});
+        }
+        std::filesystem::resize_file(journalPath, std::filesystem::file_size(journalPath) - 1);
+
+        AccountStore<BankAccount> accounts;
+        accounts.insert(account);
+        Journal journal{journalPath};
+        CHECK(journal.lastSequence() == 1);
+        CHECK(journal.replay(accounts) == 1);
+        CHECK(accounts.find(account.getAccountNumber())->getBalance() == 3'001_dollars);
+
+        // Appending carries on from the intact records
+        journal.record(account.getAccountNumber(), {Type::Deposit, 4_dollars});
+        journal.sync();
+        CHECK(Journal{journalPath}.lastSequence() == 2);
+    }
+
+    SECTION("records from many threads share flushes") {
+        constexpr int NUM_THREADS = 4;
+        constexpr int NUM_RECORDS = 5'000;
+        {
+            // Small buffers, so recording also has to wait for them
+            Journal journal{journalPath, {.maxDelay = std::chrono::milliseconds{1}, .bufferSize = 1024}};
+            std::vector<std::jthread> threads;
+            for (int i = 0; i < NUM_THREADS; ++i) {
+                threads.emplace_back([&journal, i] {
+                    for (int j = 0; j < NUM_RECORDS; ++j) {
+                        journal.record(i, {Type::Deposit, Money{j, 0}});
+                    }
+                });
+            }
+        }
+        CHECK(Journal{journalPath}.lastSequence() == NUM_THREADS * NUM_RECORDS);
+    }
+
+    SECTION("invalid files") {
+        std::ofstream{journalPath} << "Not a journal, though long enough to have a header.";
+        CHECK_THROWS_AS(Journal{journalPath}, std::runtime_error);
+
+        AccountStore<BankAccount> accounts;
+        std::filesystem::remove(journalPath);
+        {
+            Journal journal{journalPath};
+            journal.record(-1, {Type::Deposit, 1_dollars});
+        }
+        CHECK_THROWS_AS(Journal{journalPath}.replay(accounts), std::runtime_error);
+    }
+
+    std::filesystem::remove(snapshotPath);
+    std::filesystem::remove(journalPath);
+}
@@ -5,7 +5,13 @@
 #include <fmt/core.h>
 
 #include <array>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
 
 #include "money_type.h"
 
@@ -51,5 +57,89 @@ TEST_CASE("Money test", "[money]") {
         CHECK_THROWS_AS(999'999'999'999'999'999'999'999'999'999.00_dollars, std::runtime_error);
     }
 
-    SECTION("overloaded operators") {}
+    SECTION("overloaded operators") {
+        CHECK(1.50_dollars + 0.75_dollars == 2.25_dollars);
+        CHECK(10.05_dollars - 0.10_dollars == 9.95_dollars);
+        CHECK(1.50_dollars * 3 == 4.50_dollars);
+
+        CHECK(0.99_dollars < 1_dollars);
+        CHECK(100_dollars > 99.99_dollars);
+    }
+
+    SECTION("rate multiplication") {
+        CHECK(100_dollars * Rate{0.05} == 5_dollars);
+        CHECK(100'000_dollars * 1.01 == 101'000_dollars);
+        CHECK(Rate{0.05} * Rate{2.5} == Rate::fromBasisPoints(1250));
+
+        // Rounded to the nearest cent, ties to even
+        CHECK(0.10_dollars * Rate{0.5} == 0.05_dollars);
+        CHECK(0.15_dollars * Rate{0.5} == 0.08_dollars);
+        CHECK(0.25_dollars * Rate{0.5} == 0.12_dollars);
+        CHECK(0.99_dollars * Rate{0.333333} == 0.33_dollars);
+    }
+
+    SECTION("representation") {
+        STATIC_CHECK(sizeof(Money) == sizeof(std::uint64_t));
+        CHECK(1.5_dollars == Money(1, 50));
+        CHECK((12.34_dollars).totalCents() == 1234);
+        CHECK(Money::fromCents(1234) == 12.34_dollars);
+    }
+
+    SECTION("formatting") {
+        CHECK(fmt::format("{}", 0_dollars) == "$0.00");
+        CHECK(fmt::format("{}", 0.07_dollars) == "$0.07");
+        CHECK(fmt::format("{}", 999.99_dollars) == "$999.99");
+        CHECK(fmt::format("{}", 1'000_dollars) == "$1,000.00");
+        CHECK(fmt::format("{}", 3'000.5_dollars) == "$3,000.50");
+        CHECK(fmt::format("{}", 1'234'567.89_dollars) == "$1,234,567.89");
+        CHECK(fmt::format("{}", Money::fromCents(std::numeric_limits<std::uint64_t>::max())) ==
+              "$184,467,440,737,095,516.15");
+
+        CHECK(fmt::format("[{:>12}]", 1'000_dollars) == "[   $1,000.00]");
+        CHECK(fmt::format("[{:<12}]", 1'000_dollars) == "[$1,000.00   ]");
+        CHECK(std::string{12.34_dollars} == "$12.34");
+
+        const std::uint64_t count = 12'345;
+        CHECK(fmt::format("{}", util::CommaSeperated{count}) == "12,345");
+    }
+
+    SECTION("parsing") {
+        auto parse = [](std::string_view text) -> std::optional<Money> {
+            Money value;
+            const auto [end, error] = parseMoney(text, value);
+            if (error != std::errc{} || end != text.data() + text.size()) {
+                return std::nullopt;
+            }
+            return value;
+        };
+
+        CHECK(parse("0") == 0_dollars);
+        CHECK(parse("$1,234,567.89") == 1'234'567.89_dollars);
+        CHECK(parse("1234567.89") == 1'234'567.89_dollars);
+        CHECK(parse("12.5") == 12.50_dollars);
+        CHECK(parse("12.") == 12_dollars);
+        CHECK(parse("$0.07") == 0.07_dollars);
+        // Long enough to be read eight digits at a time
+        CHECK(parse("123456789012345678") == Money::fromCents(12'345'678'901'234'567'800U));
+        CHECK(parse("$184,467,440,737,095,516.15") == Money::fromCents(std::numeric_limits<std::uint64_t>::max()));
+
+        for (const auto* invalid : {"", "$", "-1", ".5", "$$1", "1,23", "1,2345", "1234,567", "12.345", "1.2.3", "1 2",
+                                    "12345678a"}) {
+            CAPTURE(invalid);
+            CHECK_FALSE(parse(invalid).has_value());
+        }
+
+        // Only the amount at the start is read
+        Money value = 1_dollars;
+        const std::string_view text = "12.34,56.78";
+        auto result = parseMoney(text, value);
+        CHECK(result.ec == std::errc{});
+        CHECK(result.ptr == text.data() + 5);
+        CHECK(value == 12.34_dollars);
+
+        CHECK(parseMoney("abc", value).ec == std::errc::invalid_argument);
+        CHECK(value == 12.34_dollars);
+        CHECK(parseMoney("$184,467,440,737,095,516.16", value).ec == std::errc::result_out_of_range);
+        CHECK(parseMoney("99999999999999999999999", value).ec == std::errc::result_out_of_range);
+    }
 }
\ No newline at end of file
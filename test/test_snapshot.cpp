@@ -0,0 +1,121 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "cd_account.h"
+#include "hi_checking_account.h"
+#include "hi_savings_account.h"
+#include "interest_handler.h"
+#include "nosc_checking_account.h"
+#include "savings_account.h"
+#include "sc_checking_account.h"
+#include "snapshot.h"
+#include "util/date_util.h"
+
+namespace {
+
+// Everything about an account which can be observed, for comparing it with its restored copy
+std::string describe(const BankAccount& account) {
+    std::string description = fmt::format("{} {} {:%D} {}\n", account.getAccountNumber(), account.getAccountName(),
+                                          account.getAccountOpeningDate(), account.getBalance());
+    for (const auto& statement : account.getAllMonthlyStatements()) {
+        description += fmt::format("{}", statement);
+    }
+    return description;
+}
+
+} // namespace
+
+TEST_CASE("Snapshots", "[account]") {
+    SimTimeManager::resetDay();
+    const InterestHandler monthly(InterestType::Monthly, 0.01);
+    const auto path = std::filesystem::temp_directory_path() / "bank_accounts_test_snapshot.bin";
+
+    AccountStore<BankAccount> accounts;
+    accounts.insert(CertificateOfDepositAccount("Cee Dee", 5'000_dollars, std::chrono::months{6}, 0.1, monthly,
+                                                SimTimeManager{}));
+    accounts.insert(SavingsAccount("Sav Ings", 3'000_dollars, monthly, SimTimeManager{}));
+    accounts.insert(HighInterestSavingsAccount("High Sav", 20'000_dollars, monthly, SimTimeManager{}));
+    accounts.insert(ServiceChargeCheckingAccount("Service Charge", 1'000_dollars, SimTimeManager{}));
+    accounts.insert(NoServiceChargeCheckingAccount("No Charge", 800_dollars, monthly, SimTimeManager{}));
+    accounts.insert(HighInterestCheckingAccount("High Check", 9'000_dollars, monthly, SimTimeManager{}));
+
+    // Some history, with the snapshot taken part way through a month
+    for (int day = 0; day < 100; ++day) {
+        for (auto& account : accounts) {
+            account.deposit(Money{day, 0});
+            account.withdraw(Money{2 * day, 50});
+        }
+        SimTimeManager::incrDay();
+        SimTimeManager::updateAll();
+    }
+    writeSnapshot(path, accounts);
+
+    const Snapshot snapshot{path};
+    REQUIRE(snapshot.size() == accounts.size());
+    CHECK(snapshot.getDate() == SimTimeManager::getDate());
+
+    SECTION("summaries without loading") {
+        for (const auto& account : accounts) {
+            const auto summary = snapshot.find(account.getAccountNumber());
+            REQUIRE(summary.has_value());
+            CHECK(summary->number == account.getAccountNumber());
+            CHECK(summary->holderName == account.getAccountName());
+            CHECK(summary->balance == account.getBalance());
+            CHECK(summary->openingDate == account.getAccountOpeningDate());
+        }
+        CHECK(snapshot.summary(0).kind == AccountKind::CertificateOfDeposit);
+        CHECK_FALSE(snapshot.find(-1).has_value());
+    }
+
+    SECTION("restored accounts match and carry on the same way") {
+        const ServiceChargeCheckingAccount before("Before", 1_dollars, SimTimeManager{});
+        AccountStore<BankAccount> restored;
+        snapshot.loadInto(restored);
+        REQUIRE(restored.size() == accounts.size());
+
+        // Interest, service charges and maturity continue from where they were
+        for (int i = 0; i < 2; ++i) {
+            for (const auto& account : accounts) {
+                const auto* copy = restored.find(account.getAccountNumber());
+                REQUIRE(copy != nullptr);
+                CHECK(describe(*copy) == describe(account));
+            }
+
+            SimTimeManager::incrDay(std::chrono::days{200});
+            SimTimeManager::updateAll();
+        }
+
+        // New accounts are numbered after the restored ones
+        const ServiceChargeCheckingAccount newAccount("New", 1_dollars, SimTimeManager{});
+        CHECK_FALSE(snapshot.find(newAccount.getAccountNumber()).has_value());
+        // Restoring does not take any numbers of its own
+        CHECK(newAccount.getAccountNumber() == before.getAccountNumber() + 1);
+    }
+
+    SECTION("invalid files") {
+        const auto badPath = std::filesystem::temp_directory_path() / "bank_accounts_test_bad_snapshot.bin";
+        std::ofstream{badPath} << "Not a snapshot, though long enough to have a header. Not a snapshot, really.";
+        CHECK_THROWS_AS(Snapshot{badPath}, std::runtime_error);
+        CHECK_THROWS_AS(Snapshot{badPath.string() + ".missing"}, std::runtime_error);
+        std::filesystem::remove(badPath);
+
+        // Nothing is replaced if the new snapshot cannot be written
+        CHECK_THROWS_AS(writeSnapshot(path / "missing", accounts), std::runtime_error);
+        CHECK(Snapshot{path}.size() == accounts.size());
+        auto tempPath = path;
+        tempPath += ".tmp";
+        CHECK_FALSE(std::filesystem::exists(tempPath));
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,118 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "interest_handler.h"
+#include "savings_account.h"
+#include "snapshot.h"
+#include "statement_archive.h"
+#include "util/date_util.h"
+
+namespace {
+
+std::vector<std::string> formatStatements(const BankAccount& account) {
+    std::vector<std::string> statements;
+    for (const auto& statement : account.getAllMonthlyStatements()) {
+        statements.push_back(fmt::format("{}", statement));
+    }
+    return statements;
+}
+
+void stepDays(int numDays) {
+    SimTimeManager::incrDay(std::chrono::days{numDays});
+    SimTimeManager::updateAll();
+}
+
+void stepToNextMonth() {
+    const auto today = SimTimeManager::getDate();
+    stepDays(static_cast<int>((today.monthEnd().toSysDays() - today.toSysDays()).count()) + 1);
+}
+
+} // namespace
+
+TEST_CASE("Statement archive", "[account]") {
+    SimTimeManager::resetDay();
+    const auto path = std::filesystem::temp_directory_path() / "bank_accounts_test_statement_archive.bin";
+
+    BankAccount account = SavingsAccount("Sav Ings", 3'000_dollars, InterestHandler(InterestType::Monthly, 0.01),
+                                         SimTimeManager{});
+    for (int day = 0; day < 400; ++day) {
+        account.deposit(Money{day % 7, 0});
+        stepDays(1);
+    }
+    const auto expected = formatStatements(account);
+
+    SECTION("old months are archived and read back") {
+        auto archive = std::make_shared<StatementArchive>(
+            path, StatementArchive::Options{.maxResidentMonths = 3, .maxResidentRecords = 10'000, .cacheSize = 2});
+        StatementArchive::setActive(archive);
+
+        // Archiving happens as months end, leaving the statements as they were. The last month was still open.
+        stepToNextMonth();
+        const auto statements = formatStatements(account);
+        REQUIRE(statements.size() == expected.size() + 1);
+        for (std::size_t i = 0; i + 1 < expected.size(); ++i) {
+            CHECK(statements[i] == expected[i]);
+        }
+        // Two completed months are left in memory, along with the open one
+        CHECK(archive->size() + 2 == expected.size());
+
+        // Reading the same month again comes from the cache
+        const auto numReads = archive->numReads();
+        const auto opened = account.getAccountOpeningDate();
+        CHECK(fmt::format("{}", account.getMonthlyStatement(opened)) == expected.front());
+        CHECK(fmt::format("{}", account.getMonthlyStatement(opened)) == expected.front());
+        CHECK(archive->numReads() == numReads + 1);
+
+        // Snapshots include archived months
+        const auto snapshotPath = std::filesystem::temp_directory_path() / "bank_accounts_test_archive_snapshot.bin";
+        AccountStore<BankAccount> accounts;
+        accounts.insert(account);
+        writeSnapshot(snapshotPath, accounts);
+        CHECK(formatStatements(Snapshot{snapshotPath}.load(0)) == statements);
+        std::filesystem::remove(snapshotPath);
+
+        // Statements stay readable after archiving stops, which then leaves further months in memory
+        StatementArchive::setActive(nullptr);
+        archive.reset();
+        stepToNextMonth();
+        CHECK(formatStatements(account).front() == expected.front());
+    }
+
+    SECTION("accounts archive their oldest months beyond a budget of records") {
+        const auto archive = std::make_shared<StatementArchive>(
+            path, StatementArchive::Options{.maxResidentMonths = 1'000, .maxResidentRecords = 0, .cacheSize = 0});
+        StatementArchive::setActive(archive);
+
+        stepToNextMonth();
+        CHECK(archive->size() == expected.size());
+        CHECK(formatStatements(account).front() == expected.front());
+        StatementArchive::setActive(nullptr);
+    }
+
+    SECTION("changing an archived month brings it back into memory") {
+        const auto archive = std::make_shared<StatementArchive>(path);
+        StoredStatement stored{account.getMonthlyStatement(account.getAccountOpeningDate())};
+        const auto numRecords = stored.resident()->records.size();
+
+        stored.archiveTo(archive, account.getAccountNumber());
+        CHECK(stored.archived());
+        CHECK(stored.resident() == nullptr);
+        CHECK(stored.load()->records.size() == numRecords);
+
+        const auto [date, record] = *stored.load()->records.begin();
+        stored.mutate().records.emplace(date, record);
+        CHECK_FALSE(stored.archived());
+        CHECK(stored.resident()->records.size() == numRecords + 1);
+    }
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "interest_handler.h"
+#include "savings_account.h"
+#include "sc_checking_account.h"
+#include "statement_renderer.h"
+#include "util/date_util.h"
+
+namespace {
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file{path};
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+} // namespace
+
+TEST_CASE("Statement rendering", "[account]") {
+    SimTimeManager::resetDay();
+    AccountStore<BankAccount> accounts;
+    auto& savings = accounts.insert(
+        SavingsAccount("Sav Ings", 3'000_dollars, InterestHandler(InterestType::Monthly, 0.01), SimTimeManager{}));
+    auto& checking = accounts.insert(ServiceChargeCheckingAccount("Check Ing", 1'000_dollars, SimTimeManager{}));
+    for (int day = 0; day < 100; ++day) {
+        savings.deposit(Money{day, 0});
+        checking.withdraw(Money{day, 50});
+        SimTimeManager::incrDay(std::chrono::days{1});
+        SimTimeManager::updateAll();
+    }
+
+    SECTION("records are laid out in columns") {
+        const auto statement = savings.getMonthlyStatement(savings.getAccountOpeningDate());
+        const auto& [date, record] = *statement.records.begin();
+        const auto expected = fmt::format("{:<80} [{:>20}] ({:>20})", "Account opened",
+                                          fmt::format("={}", record.balanceChange), record.resultantBalance);
+        CHECK(fmt::format("{}", record) == expected);
+        CHECK(fmt::format("{:>130}", record) == "    " + expected);
+    }
+
+    SECTION("matches formatting the statements") {
+        StatementRenderer renderer;
+        renderer.renderAll(savings);
+        const auto expected = fmt::format("{}", fmt::join(savings.getAllMonthlyStatements(), "\n\n"));
+        CHECK(renderer.view() == expected);
+
+        // The buffer is reused
+        renderer.clear();
+        renderer.render(*savings.getAllMonthlyStatements().begin());
+        CHECK(renderer.view() == fmt::format("{}", *savings.getAllMonthlyStatements().begin()));
+    }
+
+    SECTION("exporting every account") {
+        const auto path = std::filesystem::temp_directory_path() / "bank_accounts_test_statements.txt";
+        exportStatements(path, accounts);
+        const auto exported = readFile(path);
+
+        StatementRenderer renderer;
+        for (const auto& account : accounts) {
+            renderer.append("Account {} owned by {}, opened {:%D}\n\n", account.getAccountNumber(),
+                            account.getAccountName(), account.getAccountOpeningDate());
+            renderer.renderAll(account);
+            renderer.append("\n\n");
+        }
+        CHECK(exported == renderer.view());
+
+        // Buffers smaller than an account are written out after each one
+        {
+            StatementExporter exporter{path, 16};
+            for (const auto& account : accounts) {
+                exporter.add(account);
+            }
+            CHECK(exporter.size() == 2);
+        }
+        CHECK(readFile(path) == exported);
+        std::filesystem::remove(path);
+
+        CHECK_THROWS_AS(StatementExporter{path / "missing" / "statements.txt"}, std::runtime_error);
+    }
+}
@@ -0,0 +1,115 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "util/date_util.h"
+
+TEST_CASE("Time manager scheduling", "[time]") {
+    SimTimeManager::resetDay();
+
+    int numCalls = 0;
+    const int id = SimTimeManager::registerFn([&](DatePeriod /*period*/) { ++numCalls; });
+
+    auto step = [](int days) {
+        for (int i = 0; i < days; ++i) {
+            SimTimeManager::incrDay();
+            SimTimeManager::updateAll();
+        }
+    };
+
+    SECTION("unscheduled callbacks run on every update") {
+        step(3);
+        CHECK(numCalls == 3);
+    }
+
+    SECTION("scheduled callbacks only run once due") {
+        SimTimeManager::scheduleFn(id, SimTimeManager::getDate() + std::chrono::days{5});
+        step(4);
+        CHECK(numCalls == 0);
+        step(1);
+        CHECK(numCalls == 1);
+
+        // Remains due until rescheduled
+        step(1);
+        CHECK(numCalls == 2);
+    }
+
+    SECTION("a single step covers everything due within it") {
+        SimTimeManager::scheduleFn(id, SimTimeManager::getDate() + std::chrono::days{30});
+        SimTimeManager::incrDay(std::chrono::days{100});
+        SimTimeManager::updateAll();
+        CHECK(numCalls == 1);
+    }
+
+    SimTimeManager::deregisterFn(id);
+}
+
+TEST_CASE("Date arithmetic", "[time]") {
+    using namespace std::chrono;
+    constexpr Date jan31{2024y / January / 31};
+
+    SECTION("invalid dates") {
+        CHECK_FALSE(Date{}.ok());
+        CHECK(Date{} < jan31);
+    }
+
+    SECTION("day offsets") {
+        CHECK(jan31 + days{1} == Date{2024y / February / 1});
+        CHECK(jan31 + days{30} - days{30} == jan31);
+        CHECK(Date::diff(jan31, Date{2025y / January / 31}) == 366);
+    }
+
+    SECTION("calendar months") {
+        CHECK(jan31.monthStart() == Date{2024y / January / 1});
+        CHECK((jan31 + months{1}).monthEnd() == Date{2024y / March / 31});
+        CHECK(Date{2024y / February / 29}.monthEnd() == Date{2024y / February / 29});
+        CHECK(Date::monthsBetween(jan31, Date{2024y / March / 1}) == 2);
+        CHECK(Date::monthsBetween(Date{2023y / December / 31}, jan31) == 1);
+    }
+}
+
+TEST_CASE("Time manager registration", "[time]") {
+    SimTimeManager::resetDay();
+
+    // Every open account holds a registration, and books hold millions of accounts
+    STATIC_CHECK(SimTimeManager::MAX_REGISTRATIONS >= 50'000'000);
+
+    std::vector<int> calls;
+    std::vector<int> ids;
+    for (int i = 0; i < 5; ++i) {
+        ids.push_back(SimTimeManager::registerFn([&calls, i](DatePeriod /*period*/) { calls.push_back(i); }));
+    }
+
+    SECTION("removed ids are not reused") {
+        SimTimeManager::deregisterFn(ids[1]);
+        const int replacement = SimTimeManager::registerFn([&](DatePeriod /*period*/) { calls.push_back(5); });
+        CHECK(replacement != ids[1]);
+        CHECK_THROWS(SimTimeManager::deregisterFn(ids[1]));
+
+        SimTimeManager::incrDay();
+        SimTimeManager::updateAll();
+        std::sort(calls.begin(), calls.end());
+        CHECK(calls == std::vector{0, 2, 3, 4, 5});
+
+        ids[1] = replacement;
+    }
+
+    SECTION("rebinding keeps the schedule") {
+        SimTimeManager::scheduleFn(ids[2], SimTimeManager::getDate() + std::chrono::days{2});
+        SimTimeManager::rebindFn(ids[2], [&](DatePeriod /*period*/) { calls.push_back(-2); });
+
+        SimTimeManager::incrDay();
+        SimTimeManager::updateAll();
+        CHECK(std::count(calls.begin(), calls.end(), -2) == 0);
+
+        SimTimeManager::incrDay();
+        SimTimeManager::updateAll();
+        CHECK(std::count(calls.begin(), calls.end(), -2) == 1);
+    }
+
+    for (int id : ids) {
+        SimTimeManager::deregisterFn(id);
+    }
+}
@@ -0,0 +1,240 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "cd_account.h"
+#include "hi_checking_account.h"
+#include "hi_savings_account.h"
+#include "interest_handler.h"
+#include "sc_checking_account.h"
+#include "transaction.h"
+#include "transaction_engine.h"
+#include "util/date_util.h"
+
+TEST_CASE("Transaction engine", "[account]") {
+    SimTimeManager::resetDay();
+    const InterestHandler noInterestHandler(InterestType::Daily, 0.00);
+    constexpr std::size_t numAccounts = 64;
+    constexpr int numThreads = 8;
+    constexpr int opsPerThread = 5000;
+    const Money startingBalance = 1'000_dollars;
+
+    TransactionEngine engine{4};
+    std::vector<int> numbers;
+    for (std::size_t i = 0; i < numAccounts; ++i) {
+        if (i % 2 == 0) {
+            numbers.push_back(
+                engine.open(ServiceChargeCheckingAccount("sc_checking", startingBalance, SimTimeManager{})));
+        } else {
+            numbers.push_back(engine.open(
+                HighInterestCheckingAccount("hi_checking", startingBalance, noInterestHandler, SimTimeManager{})));
+        }
+    }
+    REQUIRE(engine.size() == numAccounts);
+
+    // Random transactions on random accounts from every thread, keeping count of what each should have done
+    std::vector<std::atomic<int>> numOps(numAccounts);
+    std::atomic<std::uint64_t> deposited = 0;
+    std::atomic<std::uint64_t> withdrawn = 0;
+    auto transact = [&](unsigned seed) {
+        std::mt19937 rng{seed};
+        std::uniform_int_distribution<std::size_t> pickAccount{0, numAccounts - 1};
+        std::uniform_int_distribution<int> pickAmount{0, 200};
+
+        for (int i = 0; i < opsPerThread; ++i) {
+            const auto index = pickAccount(rng);
+            const Money amount{pickAmount(rng), 0};
+            switch (rng() % 3) {
+            case 0:
+                engine.deposit(numbers[index], amount);
+                deposited += amount.totalCents();
+                break;
+            case 1:
+                if (engine.withdraw(numbers[index], amount)) {
+                    withdrawn += amount.totalCents();
+                }
+                break;
+            default:
+                if (engine.writeCheck(numbers[index], amount)) {
+                    withdrawn += amount.totalCents();
+                }
+                break;
+            }
+            ++numOps[index];
+        }
+    };
+
+    SECTION("balances add up") {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i) {
+            threads.emplace_back(transact, static_cast<unsigned>(i));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < numAccounts; ++i) {
+            total += engine.getBalance(numbers[i]).totalCents();
+
+            // Every transaction is recorded, along with the account being opened
+            const auto numRecords = engine.withAccount(numbers[i], [](const BankAccount& account) {
+                return account.getMonthlyStatement(account.getAccountOpeningDate()).records.size();
+            });
+            CHECK(numRecords == static_cast<std::size_t>(numOps[i]) + 1);
+        }
+        CHECK(total == startingBalance.totalCents() * numAccounts + deposited - withdrawn);
+    }
+
+    SECTION("opening, closing and updates alongside transactions") {
+        std::atomic<bool> done = false;
+        std::thread churn{[&] {
+            while (!done) {
+                const int number =
+                    engine.open([] { return ServiceChargeCheckingAccount("churn", 1_dollars, SimTimeManager{}); });
+                engine.deposit(number, 1_dollars);
+                engine.close(number);
+            }
+        }};
+        std::thread updates{[&] {
+            while (!done) {
+                engine.exclusively([] {
+                    SimTimeManager::incrDay();
+                    SimTimeManager::updateAll();
+                });
+            }
+        }};
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i) {
+            threads.emplace_back(transact, static_cast<unsigned>(i));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        done = true;
+        churn.join();
+        updates.join();
+
+        CHECK(engine.size() == numAccounts);
+        CHECK_THROWS_AS(engine.deposit(-1, 1_dollars), std::out_of_range);
+    }
+}
+
+TEST_CASE("Transfers", "[account]") {
+    SimTimeManager::resetDay();
+    const InterestHandler noInterestHandler(InterestType::Daily, 0.00);
+
+    TransactionEngine engine{4};
+    const int checking = engine.open(ServiceChargeCheckingAccount("sc_checking", 1'000_dollars, SimTimeManager{}));
+    const int savings =
+        engine.open(HighInterestSavingsAccount("hi_savings", 12'000_dollars, noInterestHandler, SimTimeManager{}));
+    const int cd = engine.open(CertificateOfDepositAccount("cd", 1'000_dollars, std::chrono::months{12}, 0.1,
+                                                           noInterestHandler, SimTimeManager{}));
+
+    // Description of the latest record on the account
+    auto lastRecord = [&](int number) {
+        return engine.withAccount(number, [](const BankAccount& account) {
+            const auto statement = account.getMonthlyStatement(SimTimeManager::getDate());
+            return fmt::format("{}", statement.records.lastOn(SimTimeManager::getDate()));
+        });
+    };
+
+    SECTION("paired records") {
+        CHECK(engine.transfer(savings, checking, 500_dollars));
+        CHECK(engine.getBalance(savings) == 11'500_dollars);
+        CHECK(engine.getBalance(checking) == 1'500_dollars);
+        CHECK(lastRecord(savings).starts_with(fmt::format("Transfer to account {} ", checking)));
+        CHECK(lastRecord(checking).starts_with(fmt::format("Transfer from account {} ", savings)));
+    }
+
+    SECTION("withdrawal rules") {
+        // Would leave the savings account below its minimum balance, so nothing moves
+        CHECK_FALSE(engine.transfer(savings, checking, 2'500_dollars));
+        CHECK(engine.getBalance(savings) == 12'000_dollars);
+        CHECK(engine.getBalance(checking) == 1'000_dollars);
+        CHECK(lastRecord(savings).starts_with("Failed to transfer "));
+        CHECK(lastRecord(checking).starts_with("Account opened"));
+
+        // Early withdrawal from the CD takes a penalty on top of what is transferred
+        CHECK(engine.transfer(cd, checking, 500_dollars));
+        CHECK(engine.getBalance(cd) == 450_dollars);
+        CHECK(engine.getBalance(checking) == 1'500_dollars);
+        CHECK(lastRecord(cd).starts_with(
+            fmt::format("Transfer of $500.00 to account {} with penalty of $50.00", checking)));
+    }
+
+    SECTION("invalid transfers change nothing") {
+        CHECK_THROWS_AS(engine.transfer(checking, cd, 10_dollars), std::invalid_argument);
+        CHECK_THROWS_AS(engine.transfer(checking, checking, 10_dollars), std::invalid_argument);
+        CHECK_THROWS_AS(engine.transfer(checking, -1, 10_dollars), std::out_of_range);
+
+        const std::array batch{Transfer{checking, savings, 10_dollars}, Transfer{savings, cd, 10_dollars}};
+        CHECK_THROWS_AS(engine.transferBatch(batch), std::invalid_argument);
+        CHECK(engine.getBalance(checking) == 1'000_dollars);
+        CHECK(engine.getBalance(savings) == 12'000_dollars);
+        CHECK(engine.getBalance(cd) == 1'000_dollars);
+    }
+
+    SECTION("concurrent transfers in every direction") {
+        constexpr int numAccounts = 16;
+        constexpr int numThreads = 8;
+        constexpr int transfersPerThread = 2000;
+        std::vector<int> numbers;
+        for (int i = 0; i < numAccounts; ++i) {
+            numbers.push_back(engine.open(ServiceChargeCheckingAccount("sc_checking", 100_dollars, SimTimeManager{})));
+        }
+
+        std::atomic<int> numSucceeded = 0;
+        auto transact = [&](unsigned seed) {
+            std::mt19937 rng{seed};
+            std::uniform_int_distribution<std::size_t> pickAccount{0, numAccounts - 1};
+            std::uniform_int_distribution<int> pickAmount{1, 60};
+            auto pickTransfer = [&] {
+                const auto from = pickAccount(rng);
+                auto to = pickAccount(rng);
+                if (to == from) {
+                    to = (to + 1) % numAccounts;
+                }
+                return Transfer{numbers[from], numbers[to], Money{pickAmount(rng), 0}};
+            };
+
+            for (int i = 0; i < transfersPerThread; ++i) {
+                if (i % 2 == 0) {
+                    const auto single = pickTransfer();
+                    numSucceeded += engine.transfer(single.from, single.to, single.amount) ? 1 : 0;
+                } else {
+                    const std::array batch{pickTransfer(), pickTransfer(), pickTransfer()};
+                    numSucceeded += static_cast<int>(engine.transferBatch(batch));
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < numThreads; ++i) {
+            threads.emplace_back(transact, static_cast<unsigned>(i));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // Money only ever moves between these accounts, and never below zero
+        Money total;
+        for (const int number : numbers) {
+            const auto balance = engine.getBalance(number);
+            CHECK(balance >= 0_dollars);
+            total += balance;
+        }
+        CHECK(total == 100_dollars * numAccounts);
+        CHECK(numSucceeded > 0);
+    }
+}
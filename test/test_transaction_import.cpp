@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "account_store.h"
+#include "bank_account.h"
+#include "interest_handler.h"
+#include "nosc_checking_account.h"
+#include "savings_account.h"
+#include "transaction_engine.h"
+#include "transaction_import.h"
+#include "util/date_util.h"
+
+namespace {
+
+struct Numbers
+{
+    int checkingA;
+    int checkingB;
+    int savings;
+};
+
+//! Writes rows for the accounts, returning the line numbers of those which should be rejected
+std::vector<std::size_t> writeRows(const std::filesystem::path& path, const Numbers& numbers) {
+    const auto today = SimTimeManager::getDate();
+    const auto day1 = today + std::chrono::days{1};
+    const auto day5 = today + std::chrono::days{5};
+
+    std::ofstream file{path};
+    file << "account,date,type,amount\r\n";
+    file << fmt::format("{},{:%F},deposit,10.00\n", numbers.checkingA, day5);
+    file << fmt::format("{},{:%F},check,\"$1,000.00\"\n", numbers.checkingA, day1);
+    file << fmt::format("{},{:%F},deposit,5\n", numbers.checkingB, day1);
+    file << "not,a,row\n";
+    file << "\n";
+    file << fmt::format("999999,{:%F},deposit,1\n", day1);
+    file << fmt::format("{},{:%F},withdrawal,20.50\n", numbers.checkingA, day1);
+    // Savings accounts cannot write checks, which only rejects the check and not the deposit alongside it
+    file << fmt::format("{},{:%F},check,1\n", numbers.savings, day1);
+    file << fmt::format("{},{:%F},deposit,3\n", numbers.savings, day1);
+    file << fmt::format("{},{:%F},deposit,1\n", numbers.checkingA, today - std::chrono::days{1});
+    file << fmt::format("{},2024-02-30,deposit,1", numbers.checkingB);
+
+    return {5, 7, 9, 11, 12};
+}
+
+void checkReport(const ImportReport& report, const std::vector<std::size_t>& rejectedLines) {
+    CHECK(report.numRows == 10);
+    CHECK(report.numApplied == 5);
+    // The check for $1,000.00 would take the account below its minimum balance
+    CHECK(report.numSucceeded == 4);
+    CHECK(report.numRejected == rejectedLines.size());
+
+    std::vector<std::size_t> lines;
+    for (const auto& rejection : report.rejections) {
+        lines.push_back(rejection.line);
+        CHECK_FALSE(rejection.reason.empty());
+    }
+    CHECK(lines == rejectedLines);
+}
+
+} // namespace
+
+TEST_CASE("Transaction import", "[account]") {
+    SimTimeManager::resetDay();
+    const auto start = SimTimeManager::getDate();
+    const InterestHandler noInterest(InterestType::Monthly, 0.0);
+    const auto path = std::filesystem::temp_directory_path() / "bank_accounts_test_import.csv";
+
+    // Small chunks, so rows are spread over several of them
+    const ImportOptions options{.numThreads = 4, .chunkSize = 16, .maxRejections = 100};
+
+    SECTION("into a transaction engine") {
+        TransactionEngine engine{4};
+        const Numbers numbers{
+            .checkingA = engine.open(NoServiceChargeCheckingAccount("A", 1'000_dollars, noInterest, SimTimeManager{})),
+            .checkingB = engine.open(NoServiceChargeCheckingAccount("B", 1'000_dollars, noInterest, SimTimeManager{})),
+            .savings = engine.open(SavingsAccount("S", 3'000_dollars, noInterest, SimTimeManager{})),
+        };
+        const auto rejectedLines = writeRows(path, numbers);
+
+        const auto report = importTransactions(path, engine, options);
+        checkReport(report, rejectedLines);
+        CHECK(SimTimeManager::getDate() == start + std::chrono::days{5});
+
+        CHECK(engine.getBalance(numbers.checkingA) == 989.50_dollars);
+        CHECK(engine.getBalance(numbers.checkingB) == 1'005_dollars);
+        CHECK(engine.getBalance(numbers.savings) == 3'003_dollars);
+    }
+
+    SECTION("into an account store") {
+        AccountStore<BankAccount> accounts;
+        auto open = [&accounts](const BankAccount& account) { return accounts.insert(account).getAccountNumber(); };
+        const Numbers numbers{
+            .checkingA = open(NoServiceChargeCheckingAccount("A", 1'000_dollars, noInterest, SimTimeManager{})),
+            .checkingB = open(NoServiceChargeCheckingAccount("B", 1'000_dollars, noInterest, SimTimeManager{})),
+            .savings = open(SavingsAccount("S", 3'000_dollars, noInterest, SimTimeManager{})),
+        };
+        const auto rejectedLines = writeRows(path, numbers);
+
+        const ImportOptions singleThreaded{.numThreads = 1, .chunkSize = std::size_t{1} << 20, .maxRejections = 2};
+        const auto report = importTransactions(path, accounts, singleThreaded);
+        CHECK(report.numRejected == rejectedLines.size());
+        CHECK(report.rejections.size() == 2);
+        CHECK(report.numSucceeded == 4);
+
+        CHECK(accounts.find(numbers.checkingA)->getBalance() == 989.50_dollars);
+        CHECK(accounts.find(numbers.checkingB)->getBalance() == 1'005_dollars);
+        CHECK(accounts.find(numbers.savings)->getBalance() == 3'003_dollars);
+    }
+
+    SECTION("empty and missing files") {
+        AccountStore<BankAccount> accounts;
+        std::ofstream{path}.close();
+        CHECK(importTransactions(path, accounts).numRows == 0);
+
+        std::filesystem::remove(path);
+        CHECK_THROWS_AS(importTransactions(path, accounts), std::runtime_error);
+    }
+
+    std::filesystem::remove(path);
+}